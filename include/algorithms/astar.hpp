@@ -5,108 +5,157 @@
 #include <optional>
 #include <algorithm>
 
-#include <directedgraph.hpp>
+#include <graph.hpp>
+#include <weighted_graph.hpp>
 #include <path_type.hpp>
 #include <callable.hpp>
+#include <search_workspace.hpp>
 #include <deque>
 #include <concepts>
+#include <limits>
 
 namespace mazes {
 class AStar {
-    template <typename DistanceType>
-    struct PQElement {
-        uint64_t node; /* node of graph */
-        uint64_t via_elmidx; /* index into finished elements */
-        DistanceType pathlen; /* combined pathlength up until node */
-        DistanceType total_heuristic;
-
-        constexpr PQElement() { };
-        constexpr PQElement(uint64_t n, uint64_t v, DistanceType pl, DistanceType th)
-            : node { n }, via_elmidx { v }, pathlen { pl }, total_heuristic { th } { };
-    };
-
 public:
-    template <typename DistanceType = float, typename D, uint64_t N,
+    template <Graph G, typename DistanceType,
         CallableWithSignature<DistanceType(uint64_t, uint64_t)> EdgeLength,
         CallableWithSignature<DistanceType(uint64_t)> Distance>
-    /// A* shortest path between from and to
-    /// \tparam EdgeLengthType Return type of get_edge_length, the type of pathlengths
+    /// A* shortest path between from and to, in the buffers of workspace -> no allocations when it is warm
     /// \param get_edge_length A function that gets to adjacent nodes and computes the length of the edge between them
-    /// \return Shortest path between nodes from and to, or std::nullopt, if no path is found
-    static constexpr std::optional<PathType<DirectedGraph<D,N>>> search(
-        const DirectedGraph<D, N>& graph,
+    /// \param get_distance_to_finish Heuristic: estimated distance from node to `to`. The path is shortest
+    ///        if it never overestimates. It does not need to be consistent, finished nodes are reopened
+    ///        when a shorter path to them is found.
+    /// \return Shortest path between nodes from and to, ordered from to to from, or std::nullopt, if no path is found.
+    ///         The path lives in workspace until its next search
+    static constexpr std::optional<PathView<G>> search(
+        const G& graph,
         const uint64_t from, const uint64_t to,
         EdgeLength&& get_edge_length,
-        Distance&& get_distance_to_finish
+        Distance&& get_distance_to_finish,
+        SearchWorkspace<typename G::IndexType, DistanceType>& workspace
         )
     {
-        using PQElm = PQElement<DistanceType>;
-        constexpr uint64_t via_none = UINT64_MAX;
-
-        /* Priority queue is split into two sections:
-         * |finished elements|priorityqueue|
-         *                    ^ beginidx
-         * finished nodes values are constant */
-        std::vector<PQElm> pqueue { { from, via_none, DistanceType(), get_distance_to_finish(from) } };
-
-        uint64_t beginidx = 0;
-        pqueue.reserve(graph.size() / 12 + 1);
-
-        std::vector<bool> in_queue(graph.size(), 0);
-        in_queue[from] = true;
-
-        /* insert element into sorted priority queue (by pathlen)*/
-        const auto insert_sorted = [&pqueue, &beginidx](PQElm&& elm) {
-            const auto p = std::find_if(
-                pqueue.begin() + beginidx, pqueue.end(),
-                [&elm](const PQElm& other) {
-                    return elm.total_heuristic < elm.total_heuristic;
-            });
-            pqueue.insert(p, elm);
-        };
+        using Index = typename G::IndexType;
+        using Workspace = SearchWorkspace<Index, DistanceType>;
+        using PQElm = typename Workspace::Step;
+        constexpr Index via_none = std::numeric_limits<Index>::max();
+
+        workspace.begin(graph.size());
+
+        /* finished (closed) elements in the order they were popped. values are constant,
+           a reopened node is finished again as a new element */
+        std::vector<PQElm>& finished = workspace.finished();
+
+        /* shortest known pathlen (g) of every discovered (marked) node, open or closed */
+        std::vector<DistanceType>& best_pathlen = workspace.pathlen();
+        workspace.mark(from);
+        best_pathlen[from] = DistanceType();
+
+        /* open set, decrease-key when a shorter path to an open node is found */
+        typename Workspace::HeuristicHeap& open = workspace.heuristic_heap();
+        open.push(from, { get_distance_to_finish(from), DistanceType(), via_none });
 
         bool path_found = false;
-        while (beginidx < pqueue.size()) { /* while queue is not empty*/
-            /* "pop front" (and push to finished) */
-            const PQElm element = pqueue.at(beginidx);
-            const uint64_t elmidx = beginidx;
-            beginidx++;
+        while (!open.empty()) { /* while queue is not empty*/
+            const auto [node, tentative] = open.pop();
 
-            in_queue[element.node] = true;
+            finished.push_back({ node, tentative.via_elmidx, tentative.pathlen });
+            const Index elmidx = finished.size() - 1;
 
-            if (element.node == to) {
+            if (node == to) {
                 path_found = true;
                 break;
             }
 
-            const Edges auto& edges = graph.edges(element.node);
-            for (const uint64_t e : edges) {
+            const EdgeView auto& edges = graph.edges(node);
+            for (uint64_t i = 0; i < edges.size(); i++) {
+                const Index e = edges[i];
                 assert(e < graph.size());
-                if (in_queue[e]) continue;
-                in_queue[e] = true;
-                const DistanceType elen = get_edge_length(element.node, e);
-                const DistanceType pathlen = element.pathlen + elen;
-                insert_sorted(PQElm(e, elmidx, pathlen, pathlen + get_distance_to_finish(e)));
+                const DistanceType pathlen = tentative.pathlen + edge_length(graph, get_edge_length, node, i, e);
+                if (workspace.marked(e) && !(pathlen < best_pathlen[e]))
+                    continue;
+
+                /* new node, shorter path to open node, or reopening of closed node */
+                workspace.mark(e);
+                best_pathlen[e] = pathlen;
+                open.push_or_decrease(e, { pathlen + get_distance_to_finish(e), pathlen, elmidx });
             }
         }
 
         if (!path_found) return std::nullopt;
 
-        const uint64_t finished_end = beginidx;
-        const PQElm& to_elm = pqueue.at(finished_end - 1);
+        const PQElm& to_elm = finished.back();
 
-        PathType<DirectedGraph<D,N>> path = { to_elm.node };
-        path.reserve(graph.size() / 24 + 1);
+        std::vector<Index>& path = workspace.path();
+        path.push_back(to_elm.node);
 
         /* reconstruct path from last node, moving backward through via_elmidx */
-        uint64_t viaidx = to_elm.via_elmidx;
+        Index viaidx = to_elm.via_elmidx;
         while (viaidx != via_none) {
-            const PQElm& elm = pqueue.at(viaidx);
+            const PQElm& elm = finished[viaidx];
             path.push_back(elm.node);
             viaidx = elm.via_elmidx;
         }
 
-        return path;
+        return PathView<G>(path);
+    }
+
+    template <typename DistanceType = float, Graph G,
+        CallableWithSignature<DistanceType(uint64_t, uint64_t)> EdgeLength,
+        CallableWithSignature<DistanceType(uint64_t)> Distance>
+    /// A* shortest path between from and to
+    /// \tparam DistanceType Return type of get_edge_length and get_distance_to_finish, the type of pathlengths
+    /// \param get_edge_length A function that gets to adjacent nodes and computes the length of the edge between them
+    /// \param get_distance_to_finish Heuristic: estimated distance from node to `to`. The path is shortest
+    ///        if it never overestimates. It does not need to be consistent, finished nodes are reopened
+    ///        when a shorter path to them is found.
+    /// \return Shortest path between nodes from and to, or std::nullopt, if no path is found
+    static constexpr std::optional<PathType<G>> search(
+        const G& graph,
+        const uint64_t from, const uint64_t to,
+        EdgeLength&& get_edge_length,
+        Distance&& get_distance_to_finish
+        )
+    {
+        SearchWorkspace<typename G::IndexType, DistanceType> workspace;
+        const std::optional<PathView<G>> path = search(graph, from, to, get_edge_length, get_distance_to_finish, workspace);
+        if (!path) return std::nullopt;
+        return PathType<G>(path->begin(), path->end());
+    }
+
+    template <WeightedGraph G, typename DistanceType,
+        CallableWithSignature<DistanceType(uint64_t)> Distance>
+        requires std::same_as<DistanceType, typename G::LengthType>
+    /// A* shortest path between from and to with the edge lengths stored in graph,
+    /// in the buffers of workspace -> no edge length callback, and no allocations when it is warm
+    /// \param get_distance_to_finish Heuristic: estimated distance from node to `to`, see above
+    /// \return Shortest path between nodes from and to, ordered from to to from, or std::nullopt, if no path is found.
+    ///         The path lives in workspace until its next search
+    static constexpr std::optional<PathView<G>> search(
+        const G& graph,
+        const uint64_t from, const uint64_t to,
+        Distance&& get_distance_to_finish,
+        SearchWorkspace<typename G::IndexType, DistanceType>& workspace
+        )
+    {
+        return search(graph, from, to, StoredLengths<G>{ graph }, get_distance_to_finish, workspace);
+    }
+
+    template <WeightedGraph G,
+        CallableWithSignature<typename G::LengthType(uint64_t)> Distance>
+    /// A* shortest path between from and to with the edge lengths stored in graph
+    /// \param get_distance_to_finish Heuristic: estimated distance from node to `to`, see above
+    /// \return Shortest path between nodes from and to, or std::nullopt, if no path is found
+    static constexpr std::optional<PathType<G>> search(
+        const G& graph,
+        const uint64_t from, const uint64_t to,
+        Distance&& get_distance_to_finish
+        )
+    {
+        SearchWorkspace<typename G::IndexType, typename G::LengthType> workspace;
+        const std::optional<PathView<G>> path = search(graph, from, to, get_distance_to_finish, workspace);
+        if (!path) return std::nullopt;
+        return PathType<G>(path->begin(), path->end());
     }
 };
-}; // namespace mazes
\ No newline at end of file
+}; // namespace mazes
@@ -2,64 +2,156 @@
 
 #pragma once
 
-#include <directedgraph.hpp>
+#include <graph.hpp>
 #include <path_type.hpp>
+#include <search_workspace.hpp>
 #include <optional>
+#include <array>
+#include <algorithm>
+#include <limits>
 
 namespace mazes {
 class BreadthFirst {
-    struct QueueElement {
-        uint64_t node;
-        uint64_t via_elmidx;
-    };
 public:
-    template <typename D, uint64_t N>
-    static constexpr std::optional<PathType<DirectedGraph<D, N>>> search(
-        const DirectedGraph<D,N>& graph,
-        const uint64_t from, const uint64_t to
+    template <Graph G, typename Distance>
+    /// Breadth first search from from to to, in the buffers of workspace -> no allocations when it is warm
+    /// \return Path with the fewest edges, ordered from to to from, or std::nullopt, if no path is found.
+    ///         The path lives in workspace until its next search
+    static constexpr std::optional<PathView<G>> search(
+        const G& graph,
+        const uint64_t from, const uint64_t to,
+        SearchWorkspace<typename G::IndexType, Distance>& workspace
         )
     {
-        static constexpr uint64_t via_none = UINT64_MAX;
-        std::vector<QueueElement> queue { { from, via_none } };
-        std::vector<bool> visited(graph.size());
-        visited[from] = true;
-        uint64_t beginidx = 0;
+        using Index = typename G::IndexType;
+        using QElm = typename SearchWorkspace<Index, Distance>::Node;
+        static constexpr Index via_none = std::numeric_limits<Index>::max();
+
+        workspace.begin(graph.size());
+        std::vector<QElm>& queue = workspace.frontier();
+        queue.push_back({ Index(from), via_none });
+        workspace.mark(from);
+        Index beginidx = 0;
 
         bool path_found = false;
         while (beginidx < queue.size()) {
             /* "pop front" */
-            const QueueElement element = queue.at(beginidx);
-            const uint64_t elmidx = beginidx;
+            const QElm element = queue[beginidx];
+            const Index elmidx = beginidx;
             beginidx++;
 
             if (element.node == to) {
                 path_found = true; break;
             }
 
-            const Edges auto & edges = graph.edges(element.node);
-            for (const uint64_t e : edges) {
-                if (visited[e]) continue;
-                visited[e] = true;
+            const EdgeView auto & edges = graph.edges(element.node);
+            for (const Index e : edges) {
+                if (workspace.marked(e)) continue;
+                workspace.mark(e);
                 queue.push_back({ e, elmidx });
             }
         }
 
         if (!path_found) return std::nullopt;
 
-        const uint64_t finished_end = beginidx;
-        const QueueElement& to_elm = queue.at(finished_end - 1);
+        const Index finished_end = beginidx;
+        const QElm& to_elm = queue[finished_end - 1];
 
-        PathType<DirectedGraph<D,N>> path = { to_elm.node };
-        path.reserve(graph.size() / 24 + 1);
+        std::vector<Index>& path = workspace.path();
+        path.push_back(to_elm.node);
 
         /* reconstruct path from last node, moving backward through via_elmidx */
-        uint64_t viaidx = to_elm.via_elmidx;
+        Index viaidx = to_elm.via_elmidx;
         while (viaidx != via_none) {
-            const QueueElement& elm = queue.at(viaidx);
+            const QElm& elm = queue[viaidx];
             path.push_back(elm.node);
             viaidx = elm.via_elmidx;
         }
 
+        return PathView<G>(path);
+    }
+
+    template <Graph G>
+    /// Breadth first search from from to to
+    /// \return Path with the fewest edges, ordered from to to from, or std::nullopt, if no path is found
+    static constexpr std::optional<PathType<G>> search(
+        const G& graph,
+        const uint64_t from, const uint64_t to
+        )
+    {
+        SearchWorkspace<typename G::IndexType> workspace;
+        const std::optional<PathView<G>> path = search(graph, from, to, workspace);
+        if (!path) return std::nullopt;
+        return PathType<G>(path->begin(), path->end());
+    }
+
+    template <Graph G>
+    /// Bidirectional breadth first search: alternately expands a whole level of the smaller of
+    /// the frontiers around from and to, until a level connects them.
+    /// \remark Graph must be symmetric (every edge has its reverse, as created by connect)
+    /// \return Path with the fewest edges, ordered from to to from like search, or std::nullopt, if no path is found
+    static constexpr std::optional<PathType<G>> search_bidirectional(
+        const G& graph,
+        const uint64_t from, const uint64_t to
+        )
+    {
+        using Index = typename G::IndexType;
+        static constexpr Index unvisited = std::numeric_limits<Index>::max();
+        constexpr uint64_t fwd = 0, bwd = 1;
+
+        /* for each side: node it was discovered from (root: itself), and distance to the root */
+        std::array<std::vector<Index>, 2> via {
+            std::vector<Index>(graph.size(), unvisited),
+            std::vector<Index>(graph.size(), unvisited) };
+        std::array<std::vector<Index>, 2> dist {
+            std::vector<Index>(graph.size()),
+            std::vector<Index>(graph.size()) };
+        std::array<std::vector<Index>, 2> frontier { std::vector<Index> { Index(from) }, std::vector<Index> { Index(to) } };
+        std::vector<Index> next;
+
+        via[fwd][from] = from;
+        via[bwd][to] = to;
+
+        Index meet = (from == to) ? from : unvisited;
+        uint64_t best = 0;
+        while (meet == unvisited && !frontier[fwd].empty() && !frontier[bwd].empty()) {
+            const uint64_t side = frontier[fwd].size() <= frontier[bwd].size() ? fwd : bwd;
+            const uint64_t other = 1 - side;
+
+            /* expand the whole level: the shortest meeting can be any node discovered in it */
+            next.clear();
+            for (const Index node : frontier[side]) {
+                const EdgeView auto & edges = graph.edges(node);
+                for (const Index e : edges) {
+                    if (via[side][e] != unvisited) continue;
+                    via[side][e] = node;
+                    dist[side][e] = dist[side][node] + 1;
+                    next.push_back(e);
+
+                    if (via[other][e] != unvisited &&
+                        (meet == unvisited || dist[side][e] + dist[other][e] < best)) {
+                        meet = e;
+                        best = dist[side][e] + dist[other][e];
+                    }
+                }
+            }
+            std::swap(frontier[side], next);
+        }
+
+        if (meet == unvisited) return std::nullopt;
+
+        /* to ... meet, then meet ... from */
+        PathType<G> path;
+        path.reserve(best + 1);
+        for (Index n = meet; n != to; n = via[bwd][n])
+            path.push_back(n);
+        path.push_back(to);
+        std::reverse(path.begin(), path.end());
+        for (Index n = meet; n != from; ) {
+            n = via[fwd][n];
+            path.push_back(n);
+        }
+
         return path;
     }
 };
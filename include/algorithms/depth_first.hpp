@@ -1,140 +1,234 @@
 #pragma once
-#include <directedgraph.hpp>
+#include <graph.hpp>
 #include <optional>
+#include <vector>
+#include <limits>
+#include <cassert>
+#include <span>
+#include <algorithm>
 #include <callable.hpp>
 #include <path_type.hpp>
+#include <search_workspace.hpp>
 
 namespace mazes {
 
-class DepthFirst {
-    /// @return implementation: whether the algorithm should continue
-    template <typename D, uint64_t N>
-    static constexpr bool find_path(
-        const DirectedGraph<D, N>& graph,
-        PathType <DirectedGraph<D, N>>& path,
-        std::vector<bool>& visited,
-        const uint64_t from, const uint64_t to)
+/// Enumerates all simple paths (no node twice) from from to to in depth first order, one per next().
+/// The recursion is an explicit stack of two contiguous arrays: the nodes of the current path and,
+/// for each of them, the position of the next edge to try -> 2 indices per path node, no call frames,
+/// so paths of tens of millions of nodes only cost memory, and the enumeration can be paused and resumed.
+/// \tparam G graph, any Graph
+template <Graph G>
+class DepthFirstCursor {
+public:
+    using Index = typename G::IndexType;
+
+    /// Result of a step-limited next()
+    enum class Step {
+        found,  /* path() is the next path */
+        done,   /* no more paths */
+        paused  /* step limit reached, call next() again to continue */
+    };
+
+    constexpr DepthFirstCursor(const G& graph, const uint64_t from, const uint64_t to)
+        : graph_{&graph}, to_{Index(to)}, on_path_(graph.size())
     {
-        path.push_back(from);
-        if (from == to)
-            return true;
-
-        const Edges auto& edges = graph.edges(from);
-        for (uint64_t i = 0; i < edges.size(); i++) {
-            const uint64_t e = edges[i];
-            if (visited[e]) continue;
-            visited[e] = true;
-            if (find_path(graph, path, visited, e, to))
-                return true;
-            visited[e] = false;
+        push(Index(from));
+    }
+
+    /// @brief Restart with only the paths that begin with prefix
+    /// @param prefix simple path starting at any node, its nodes are never left by the enumeration
+    constexpr void reset(const std::span<const Index> prefix) {
+        while (!path_.empty())
+            pop();
+        found_ = false;
+        floor_ = 0;
+
+        for (const Index node : prefix) {
+            assert(!on_path_[node] && "prefix must be a simple path");
+            if (!path_.empty()) /* fixed node: no edges left to try */
+                next_edge_.back() = graph_->edges(path_.back()).size();
+            push(node);
         }
+    }
 
-        path.pop_back();
-        return false;
+    /// @brief Advance to the next path
+    /// @return false if there are no more paths
+    constexpr bool next() {
+        return next(std::numeric_limits<uint64_t>::max()) == Step::found;
     }
 
-    template <typename D, size_t N,
-        CallableWithSignature<void(const PathType<DirectedGraph<D, N>>&)> OnFindFunc>
-    static constexpr void find_all_paths_unstoppable(
-        const DirectedGraph<D, N>& graph,
-        PathType<DirectedGraph<D, N>>& path,
-        std::vector<bool>& visited,
-        const uint64_t from, const uint64_t to,
-        OnFindFunc&& on_find)
-    {
-        path.push_back(from);
+    /// @brief Advance to the next path, but try at most max_steps edges
+    constexpr Step next(uint64_t max_steps) {
+        /* resume after the last found path: leave to */
+        if (found_)
+            pop();
+        found_ = false;
+
+        while (!path_.empty()) {
+            const Index node = path_.back();
+            /* a path ends at to: reported as soon as to is reached, to is never expanded */
+            if (node == to_) {
+                found_ = true;
+                return Step::found;
+            }
+
+            if (max_steps-- == 0)
+                return Step::paused;
+
+            const EdgeView auto& edges = graph_->edges(node);
+            Index& i = next_edge_.back();
+            if (i == edges.size()) {
+                pop();
+                continue;
+            }
 
-        if (from == to) {
-            on_find(path);
-        } else {
-            const auto& edges = graph.edges(from);
-            for (uint64_t i = 0; i < edges.size(); i++) {
-                const uint64_t e = edges[i];
-                if (visited[e]) continue;
-                visited[e] = true;
-                find_all_paths_unstoppable(graph, path, visited, e, to, on_find);
-                visited[e] = false;
+            const Index e = edges[i++];
+            if (!on_path_[e])
+                push(e);
+        }
+
+        return Step::done;
+    }
+
+    /// @brief Give away the shallowest untried edge: the cursor will not enumerate the paths that
+    ///        begin with task any more, they are left to whoever resets a cursor to task.
+    ///        Shallow edges lead to the largest remaining subtrees
+    /// @param task receives the path prefix ending with the edge
+    /// @return false if there is no edge left to give away
+    constexpr bool split(PathType<G>& task) {
+        /* the top node is expanded by next(), or is to which is never expanded */
+        for (uint64_t depth = floor_; depth + 1 < path_.size(); depth++) {
+            const EdgeView auto& edges = graph_->edges(path_[depth]);
+            Index& i = next_edge_[depth];
+            const auto prefix_end = path_.begin() + depth + 1;
+            for (; i < edges.size(); i++) {
+                /* nodes on the prefix stay on the path as long as depth does -> skipped by next() too */
+                const Index e = edges[i];
+                if (std::find(path_.begin(), prefix_end, e) != prefix_end) continue;
+
+                task.assign(path_.begin(), prefix_end);
+                task.push_back(e);
+                i++;
+                return true;
             }
+            floor_ = depth + 1; /* frames below have no edges left */
         }
+        return false;
+    }
 
-        path.pop_back();
+    /// @return current path, ordered from from to to. Only valid after next() returned true
+    constexpr const PathType<G>& path() const noexcept {
+        assert(found_);
+        return path_;
     }
 
-    template <typename D, size_t N,
-        CallableWithSignature<bool(const PathType<DirectedGraph<D, N>>&)> OnFindFunc>
-    static constexpr bool find_all_paths_stoppable(
-        const DirectedGraph<D, N>& graph,
-        PathType<DirectedGraph<D, N>>& path,
-        std::vector<bool>& visited,
+private:
+    constexpr void push(const Index node) {
+        path_.push_back(node);
+        next_edge_.push_back(0);
+        on_path_[node] = true;
+    }
+
+    constexpr void pop() noexcept {
+        on_path_[path_.back()] = false;
+        path_.pop_back();
+        next_edge_.pop_back();
+        floor_ = std::min<uint64_t>(floor_, path_.size());
+    }
+
+    const G* graph_;
+    Index to_;
+    PathType<G> path_; /* nodes of the current path */
+    std::vector<Index> next_edge_; /* for each node of path_: position of its next edge to try */
+    std::vector<bool> on_path_;
+    bool found_ = false; /* path_ ends at to and was reported */
+    uint64_t floor_ = 0; /* nodes of path_ below floor_ have no edges left to try */
+};
+
+class DepthFirst {
+public:
+    template <Graph G, typename Distance>
+    static constexpr std::optional<PathView<G>>
+    /// Search and find a path through graph from from to to, in the buffers of workspace.
+    /// Iterative with an explicit stack, every node is visited at most once -> O(n + m)
+    /// \return found path, ordered from from to to, or std::nullopt if no path was found.
+    ///         The path lives in workspace until its next search
+    search(const G& graph,
         const uint64_t from, const uint64_t to,
-        OnFindFunc&& on_find
-        )
+        SearchWorkspace<typename G::IndexType, Distance>& workspace)
     {
-        if (visited[from]) return true;
+        using Index = typename G::IndexType;
 
+        workspace.begin(graph.size());
+        std::vector<Index>& path = workspace.path();
+        std::vector<Index>& next_edge = workspace.next_edge();
         path.push_back(from);
-        visited[from] = true;
-
-        if (from == to) {
-            on_find(path);
-        } else {
-            const auto& edges = graph.edges(from);
-            for (uint64_t i = 0; i < edges.size(); i++) {
-                if (!find_all_paths_stoppable(graph, path, visited, edges[i], to, on_find))
-                    return false;
+        next_edge.push_back(0);
+        workspace.mark(from);
+
+        while (!path.empty()) {
+            const Index node = path.back();
+            if (node == to)
+                return PathView<G>(path);
+
+            const EdgeView auto& edges = graph.edges(node);
+            Index& i = next_edge.back();
+            if (i == edges.size()) { /* dead end: backtrack, node stays marked */
+                path.pop_back();
+                next_edge.pop_back();
+                continue;
             }
+
+            const Index e = edges[i++];
+            if (workspace.marked(e)) continue;
+            workspace.mark(e);
+            path.push_back(e);
+            next_edge.push_back(0);
         }
 
-        path.pop_back();
-        visited[from] = false;
-        return true;
+        return std::nullopt;
     }
 
-public:
-    template <typename D, uint64_t N>
-    static constexpr std::optional<PathType < DirectedGraph<D, N>>>
+    template <Graph G>
+    static constexpr std::optional<PathType<G>>
     /// Search and find a path through graph from from to to
     /// \return found path or std::nullopt if no path was found
-    search(const DirectedGraph<D, N>& graph,
+    search(const G& graph,
         const uint64_t from, const uint64_t to)
     {
-        std::vector<bool> visited(graph.size());
-        visited[from] = true;
-        PathType <DirectedGraph<D, N>> path;
-        bool success = find_path(graph, path, visited, from, to);
-        if (success) {
-            return path;
-        } else return {};
+        SearchWorkspace<typename G::IndexType> workspace;
+        const std::optional<PathView<G>> path = search(graph, from, to, workspace);
+        if (!path) return std::nullopt;
+        return PathType<G>(path->begin(), path->end());
     }
 
-    template <typename D, uint64_t N, CallableWithSignature<bool(const PathType<DirectedGraph<D, N>>&)> OnFindFunc>
+    template <Graph G, CallableWithSignature<bool(const PathType<G>&)> OnFindFunc>
     // Search for all paths in directed graph.
     // calls on_find when a path is found. If
     // on_find returns false, the search is
     // stopped.
     static constexpr void search_and_continue(
-        const DirectedGraph<D, N>& graph,
+        const G& graph,
         const uint64_t from, const uint64_t to,
         OnFindFunc&& on_find)
     {
-        PathType<DirectedGraph<D, N>> path;
-        std::vector<bool> visited(graph.size());
-        visited[from] = true;
-        find_all_paths_stoppable(graph, path, visited, from, to, on_find);
+        DepthFirstCursor<G> cursor(graph, from, to);
+        while (cursor.next())
+            if (!on_find(cursor.path()))
+                return;
     }
 
-    template <typename D, uint64_t N,
-        CallableWithSignature<void(const PathType<DirectedGraph<D, N>>&)> OnFindFunc>
+    template <Graph G,
+        CallableWithSignature<void(const PathType<G>&)> OnFindFunc>
     /* Search for all paths in directed graph -> calls on_find when a path is found. */
     static constexpr void search_and_continue(
-        const DirectedGraph<D, N>& graph,
+        const G& graph,
         const uint64_t from, const uint64_t to,
         OnFindFunc&& on_find)
     {
-        PathType<decltype(graph)> path;
-        std::vector<bool> visited(graph.size());
-        visited[from] = true;
-        find_all_paths_unstoppable(graph, path, visited, from, to, on_find);
+        DepthFirstCursor<G> cursor(graph, from, to);
+        while (cursor.next())
+            on_find(cursor.path());
     }
 };
-};
\ No newline at end of file
+};
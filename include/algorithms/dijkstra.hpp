@@ -5,52 +5,437 @@
 #include <optional>
 #include <algorithm>
 
-#include <directedgraph.hpp>
+#include <graph.hpp>
+#include <weighted_graph.hpp>
 #include <path_type.hpp>
 #include <callable.hpp>
+#include <indexed_heap.hpp>
+#include <bucket_queue.hpp>
+#include <search_workspace.hpp>
 #include <deque>
+#include <array>
 #include <concepts>
+#include <limits>
 
 namespace mazes {
 class Dijkstra {
-    template <typename EdgeLengthType>
+    template <typename EdgeLengthType, typename Index>
     struct PQElement {
-        uint64_t node; /* node of graph */
-        uint64_t via_elmidx; /* index into finished elements */
+        Index node; /* node of graph */
+        Index via_elmidx; /* index into finished elements */
         EdgeLengthType pathlen; /* combined pathlength up until node */
 
         constexpr PQElement() { };
-        constexpr PQElement(uint64_t n, uint64_t v, EdgeLengthType pl)
+        constexpr PQElement(Index n, Index v, EdgeLengthType pl)
             : node { n }, via_elmidx { v }, pathlen { pl } { };
     };
 
+    template <Graph G, typename EdgeLengthType, typename Queue, typename EdgeLength>
+    /// Dijkstra on a monotone queue without decrease-key: a node is pushed for every edge that reaches it,
+    /// and only its first pop (the shortest) is finished, later pops are stale and skipped.
+    static constexpr std::optional<PathView<G>> search_lazy(
+        Queue& pqueue,
+        const G& graph,
+        const uint64_t from, const uint64_t to,
+        EdgeLength&& get_edge_length,
+        SearchWorkspace<typename G::IndexType, EdgeLengthType>& workspace
+        )
+    {
+        using Index = typename G::IndexType;
+        constexpr Index via_none = std::numeric_limits<Index>::max();
+
+        /* finished (settled, marked) elements in the order they were popped. values are constant */
+        auto& finished = workspace.finished();
+
+        pqueue.push(EdgeLengthType(), { Index(from), via_none });
+
+        bool path_found = false;
+        while (!pqueue.empty()) { /* while queue is not empty*/
+            const auto [pathlen, element] = pqueue.pop();
+            if (workspace.marked(element.node)) continue; /* stale */
+            workspace.mark(element.node);
+
+            finished.push_back({ element.node, element.via_elmidx, pathlen });
+            const Index elmidx = finished.size() - 1;
+
+            if (element.node == to) {
+                path_found = true;
+                break;
+            }
+
+            const EdgeView auto& edges = graph.edges(element.node);
+            for (uint64_t i = 0; i < edges.size(); i++) {
+                const Index e = edges[i];
+                if (workspace.marked(e)) continue;
+                const EdgeLengthType elen = edge_length(graph, get_edge_length, element.node, i, e);
+                pqueue.push(pathlen + elen, { e, elmidx });
+            }
+        }
+
+        if (!path_found) return std::nullopt;
+        return reconstruct_path<G>(workspace);
+    }
+
+    template <Graph G, typename Workspace>
+    /// reconstruct path from last finished node into the path of workspace, moving backward through via_elmidx
+    static constexpr PathView<G> reconstruct_path(Workspace& workspace)
+    {
+        using Index = typename G::IndexType;
+        constexpr Index via_none = std::numeric_limits<Index>::max();
+        const auto& finished = workspace.finished();
+        const auto& to_elm = finished.back();
+
+        std::vector<Index>& path = workspace.path();
+        path.push_back(to_elm.node);
+
+        Index viaidx = to_elm.via_elmidx;
+        while (viaidx != via_none) {
+            const auto& elm = finished[viaidx];
+            path.push_back(elm.node);
+            viaidx = elm.via_elmidx;
+        }
+
+        return PathView<G>(path);
+    }
+
+    /// @return owning copy of a path found in a workspace
+    template <Graph G>
+    static constexpr std::optional<PathType<G>> to_owned(const std::optional<PathView<G>>& path)
+    {
+        if (!path) return std::nullopt;
+        return PathType<G>(path->begin(), path->end());
+    }
+
     static constexpr auto always_one = [](uint64_t, uint64_t) -> long { return long(1); };
 
 public:
-    template <typename EdgeLengthType = long, typename D, uint64_t N,
+    template <Graph G, typename EdgeLengthType,
+        CallableWithSignature<EdgeLengthType(uint64_t, uint64_t)> EdgeLength>
+    /// Dijkstra's shortest path between from and to, in the buffers of workspace -> no allocations when it is warm
+    /// \param get_edge_length A function that gets to adjacent nodes and computes the length of the edge between them
+    /// \return Shortest path between nodes from and to, ordered from to to from, or std::nullopt, if no path is found.
+    ///         The path lives in workspace until its next search
+    /// \remark Integral lengths use search_radix, all other types search_heap.
+    static constexpr std::optional<PathView<G>> search(
+        const G& graph,
+        const uint64_t from, const uint64_t to,
+        EdgeLength&& get_edge_length,
+        SearchWorkspace<typename G::IndexType, EdgeLengthType>& workspace
+        )
+    {
+        if constexpr (std::is_integral_v<EdgeLengthType>)
+            return Dijkstra::search_radix(graph, from, to, get_edge_length, workspace);
+        else
+            return Dijkstra::search_heap(graph, from, to, get_edge_length, workspace);
+    }
+
+    template <typename EdgeLengthType = long, Graph G,
+        CallableWithSignature<EdgeLengthType(uint64_t, uint64_t)> EdgeLength>
+    /// Dijkstra's shortest path between from and to
+    /// \tparam EdgeLengthType Return type of get_edge_length, the type of pathlengths.
+    ///         Integral lengths use search_radix, all other types search_heap.
+    /// \param get_edge_length A function that gets to adjacent nodes and computes the length of the edge between them
+    /// \return Shortest path between nodes from and to, or std::nullopt, if no path is found
+    static constexpr std::optional<PathType<G>> search(
+        const G& graph,
+        const uint64_t from, const uint64_t to,
+        EdgeLength&& get_edge_length
+        )
+    {
+        SearchWorkspace<typename G::IndexType, EdgeLengthType> workspace;
+        return to_owned<G>(Dijkstra::search(graph, from, to, get_edge_length, workspace));
+    }
+
+    template <Graph G, std::integral EdgeLengthType,
+        CallableWithSignature<EdgeLengthType(uint64_t, uint64_t)> EdgeLength>
+    /// Dijkstra's shortest path between from and to, for non-negative integral edge lengths,
+    /// in the buffers of workspace
+    /// \return Shortest path between nodes from and to, or std::nullopt, if no path is found.
+    ///         The path lives in workspace until its next search
+    static constexpr std::optional<PathView<G>> search_radix(
+        const G& graph,
+        const uint64_t from, const uint64_t to,
+        EdgeLength&& get_edge_length,
+        SearchWorkspace<typename G::IndexType, EdgeLengthType>& workspace
+        )
+    {
+        workspace.begin(graph.size());
+        return Dijkstra::search_lazy<G>(workspace.radix(), graph, from, to, get_edge_length, workspace);
+    }
+
+    template <std::integral EdgeLengthType = long, Graph G,
+        CallableWithSignature<EdgeLengthType(uint64_t, uint64_t)> EdgeLength>
+    /// Dijkstra's shortest path between from and to, for non-negative integral edge lengths
+    /// \return Shortest path between nodes from and to, or std::nullopt, if no path is found
+    /// \remark Priority queue is a radix heap -> no key comparisons, amortized O(log C) per element.
+    ///         1001x1001 maze (177k nodes) with corridor lengths: 14.3 ms per query, search_heap: 23.3 ms.
+    static constexpr std::optional<PathType<G>> search_radix(
+        const G& graph,
+        const uint64_t from, const uint64_t to,
+        EdgeLength&& get_edge_length
+        )
+    {
+        SearchWorkspace<typename G::IndexType, EdgeLengthType> workspace;
+        return to_owned<G>(Dijkstra::search_radix(graph, from, to, get_edge_length, workspace));
+    }
+
+    template <std::integral EdgeLengthType = long, Graph G,
+        CallableWithSignature<EdgeLengthType(uint64_t, uint64_t)> EdgeLength>
+    /// Dijkstra's shortest path between from and to, for integral edge lengths in [0, max_edge_length]
+    /// \param max_edge_length upper bound of get_edge_length, e.g. the width or height of the maze
+    /// \return Shortest path between nodes from and to, or std::nullopt, if no path is found
+    /// \remark Priority queue is Dial's buckets -> O(1) push and amortized O(1) pop.
+    ///         1001x1001 maze (177k nodes) with unit lengths: 10.2 ms per query, search_heap: 24.0 ms.
+    static constexpr std::optional<PathType<G>> search_dial(
+        const G& graph,
+        const uint64_t from, const uint64_t to,
+        const EdgeLengthType max_edge_length,
+        EdgeLength&& get_edge_length
+        )
+    {
+        using Workspace = SearchWorkspace<typename G::IndexType, EdgeLengthType>;
+        Workspace workspace;
+        workspace.begin(graph.size());
+        DialQueue<EdgeLengthType, typename Workspace::Node> pqueue(max_edge_length);
+        return to_owned<G>(Dijkstra::search_lazy<G>(pqueue, graph, from, to, get_edge_length, workspace));
+    }
+
+    template <Graph G, typename EdgeLengthType,
+        CallableWithSignature<EdgeLengthType(uint64_t, uint64_t)> EdgeLength>
+    /// Dijkstra's shortest path between from and to on an indexed heap, in the buffers of workspace
+    /// \return Shortest path between nodes from and to, or std::nullopt, if no path is found.
+    ///         The path lives in workspace until its next search
+    static constexpr std::optional<PathView<G>> search_heap(
+        const G& graph,
+        const uint64_t from, const uint64_t to,
+        EdgeLength&& get_edge_length,
+        SearchWorkspace<typename G::IndexType, EdgeLengthType>& workspace
+        )
+    {
+        using Index = typename G::IndexType;
+        constexpr Index via_none = std::numeric_limits<Index>::max();
+
+        workspace.begin(graph.size());
+
+        /* finished (settled, marked) elements in the order they were popped. values are constant */
+        auto& finished = workspace.finished();
+
+        /* nodes discovered, but not finished. keyed by pathlen, decrease-key on shorter paths */
+        auto& pqueue = workspace.path_heap();
+        pqueue.push(from, { EdgeLengthType(), via_none });
+
+        bool path_found = false;
+        while (!pqueue.empty()) { /* while queue is not empty*/
+            const auto [node, tentative] = pqueue.pop();
+            workspace.mark(node);
+
+            finished.push_back({ node, tentative.via_elmidx, tentative.pathlen });
+            const Index elmidx = finished.size() - 1;
+
+            if (node == to) {
+                path_found = true;
+                break;
+            }
+
+            const EdgeView auto& edges = graph.edges(node);
+            for (uint64_t i = 0; i < edges.size(); i++) {
+                const Index e = edges[i];
+                if (workspace.marked(e)) continue;
+                const EdgeLengthType elen = edge_length(graph, get_edge_length, node, i, e);
+                pqueue.push_or_decrease(e, { tentative.pathlen + elen, elmidx });
+            }
+        }
+
+        if (!path_found) return std::nullopt;
+        return reconstruct_path<G>(workspace);
+    }
+
+    template <typename EdgeLengthType = long, Graph G,
         CallableWithSignature<EdgeLengthType(uint64_t, uint64_t)> EdgeLength>
     /// Dijkstra's shortest path between from and to
     /// \tparam EdgeLengthType Return type of get_edge_length, the type of pathlengths
     /// \param get_edge_length A function that gets to adjacent nodes and computes the length of the edge between them
     /// \return Shortest path between nodes from and to, or std::nullopt, if no path is found
-    /// \remark 4097294 µs, 4.09729 seconds for 100000 iterations on 101x101 maze with >14000 solutions
+    /// \remark Priority queue is a 4-ary indexed heap with decrease-key -> O((n + m) log n),
+    ///         and exact for any non-negative edge lengths.
+    ///         3001x3001 open maze (2.2M nodes): 0.41 seconds, search_sorted: 1.37 seconds.
+    ///         100000 iterations on 101x101 maze: 5.05 seconds, search_sorted: 2.61 seconds (same machine),
+    ///         the queue of a narrow maze only holds a handful of elements, so linear insertion is cheap there.
+    static constexpr std::optional<PathType<G>> search_heap(
+        const G& graph,
+        const uint64_t from, const uint64_t to,
+        EdgeLength&& get_edge_length
+        )
+    {
+        SearchWorkspace<typename G::IndexType, EdgeLengthType> workspace;
+        return to_owned<G>(Dijkstra::search_heap(graph, from, to, get_edge_length, workspace));
+    }
+
+    template <Graph G, std::integral EdgeLengthType>
+        requires (!WeightedGraph<G>)
+    /// Dijkstra with unit edge lengths (fewest edges), in the buffers of workspace.
+    /// Graphs with stored edge lengths use those instead, see below
+    /// \return path with the fewest edges, or std::nullopt, if no path is found.
+    ///         The path lives in workspace until its next search
+    static constexpr std::optional<PathView<G>> search(
+        const G& graph,
+        const uint64_t from, const uint64_t to,
+        SearchWorkspace<typename G::IndexType, EdgeLengthType>& workspace
+        )
+    {
+        return Dijkstra::search_radix(graph, from, to,
+            [](uint64_t, uint64_t) -> EdgeLengthType { return EdgeLengthType(1); }, workspace);
+    }
+
+    template <Graph G>
+    static constexpr std::optional<PathType<G>> search(
+        const G& graph,
+        const uint64_t from, const uint64_t to
+        )
+    {
+        return Dijkstra::search_dial<long>(graph, from, to, 1, always_one);
+    }
+
+    template <WeightedGraph G, typename EdgeLengthType>
+        requires std::same_as<EdgeLengthType, typename G::LengthType>
+    /// Dijkstra's shortest path between from and to with the edge lengths stored in graph,
+    /// in the buffers of workspace -> no edge length callback, and no allocations when it is warm
+    /// \return Shortest path between nodes from and to, ordered from to to from, or std::nullopt, if no path is found.
+    ///         The path lives in workspace until its next search
+    static constexpr std::optional<PathView<G>> search(
+        const G& graph,
+        const uint64_t from, const uint64_t to,
+        SearchWorkspace<typename G::IndexType, EdgeLengthType>& workspace
+        )
+    {
+        return Dijkstra::search(graph, from, to, StoredLengths<G>{ graph }, workspace);
+    }
+
+    template <WeightedGraph G>
+    /// Dijkstra's shortest path between from and to with the edge lengths stored in graph
+    /// \return Shortest path between nodes from and to, or std::nullopt, if no path is found
+    /// \remark 1001x1001 maze (177k nodes), random queries: 5.5 ms, 15 ms with a float edge length callback.
+    static constexpr std::optional<PathType<G>> search(
+        const G& graph,
+        const uint64_t from, const uint64_t to
+        )
+    {
+        SearchWorkspace<typename G::IndexType, typename G::LengthType> workspace;
+        return to_owned<G>(Dijkstra::search(graph, from, to, workspace));
+    }
+
+    template <typename EdgeLengthType = long, Graph G,
+        CallableWithSignature<EdgeLengthType(uint64_t, uint64_t)> EdgeLength>
+    /// Bidirectional Dijkstra: alternately settles a node of the search around from and of the
+    /// search around to (the one with the smaller distance), until the sum of both queue tops
+    /// is no shorter than the shortest path through a node reached by both.
+    /// \remark Graph must be symmetric (every edge has its reverse, as created by connect).
+    ///         The backward search calls get_edge_length in the direction of the edges of the path.
+    /// \return Shortest path, ordered from to to from like search, or std::nullopt, if no path is found
+    static constexpr std::optional<PathType<G>> search_bidirectional(
+        const G& graph,
+        const uint64_t from, const uint64_t to,
+        EdgeLength&& get_edge_length
+        )
+    {
+        using Index = typename G::IndexType;
+        constexpr Index via_none = std::numeric_limits<Index>::max();
+        constexpr uint64_t fwd = 0, bwd = 1;
+
+        /* for each side: shortest known pathlen from its root, and previous node on that path */
+        std::array<std::vector<EdgeLengthType>, 2> pathlen {
+            std::vector<EdgeLengthType>(graph.size()),
+            std::vector<EdgeLengthType>(graph.size()) };
+        std::array<std::vector<Index>, 2> via {
+            std::vector<Index>(graph.size(), via_none),
+            std::vector<Index>(graph.size(), via_none) };
+        std::array<std::vector<bool>, 2> done {
+            std::vector<bool>(graph.size(), 0),
+            std::vector<bool>(graph.size(), 0) };
+        std::array<IndexedHeap<EdgeLengthType, std::less<>, 4, Index>, 2> pqueue {
+            IndexedHeap<EdgeLengthType, std::less<>, 4, Index>(graph.size()),
+            IndexedHeap<EdgeLengthType, std::less<>, 4, Index>(graph.size()) };
+
+        via[fwd][from] = from;
+        via[bwd][to] = to;
+        pqueue[fwd].push(from, EdgeLengthType());
+        pqueue[bwd].push(to, EdgeLengthType());
+
+        /* node on the shortest known path, and its length */
+        Index meet = (from == to) ? from : via_none;
+        EdgeLengthType best = EdgeLengthType();
+
+        while (!pqueue[fwd].empty() && !pqueue[bwd].empty()) {
+            const EdgeLengthType top_fwd = pqueue[fwd].top().key, top_bwd = pqueue[bwd].top().key;
+            if (meet != via_none && !(top_fwd + top_bwd < best))
+                break;
+
+            const uint64_t side = top_fwd <= top_bwd ? fwd : bwd;
+            const uint64_t other = 1 - side;
+
+            const auto [node, len] = pqueue[side].pop();
+            done[side][node] = true;
+
+            const EdgeView auto& edges = graph.edges(node);
+            for (const Index e : edges) {
+                if (done[side][e]) continue;
+                const EdgeLengthType elen = (side == fwd) ? get_edge_length(node, e) : get_edge_length(e, node);
+                if (pqueue[side].push_or_decrease(e, len + elen)) {
+                    pathlen[side][e] = len + elen;
+                    via[side][e] = node;
+                }
+
+                if (via[other][e] != via_none) {
+                    const EdgeLengthType through = pathlen[side][e] + pathlen[other][e];
+                    if (meet == via_none || through < best) {
+                        meet = e;
+                        best = through;
+                    }
+                }
+            }
+        }
+
+        if (meet == via_none) return std::nullopt;
+
+        /* to ... meet, then meet ... from */
+        PathType<G> path;
+        for (Index n = meet; n != to; n = via[bwd][n])
+            path.push_back(n);
+        path.push_back(to);
+        std::reverse(path.begin(), path.end());
+        for (Index n = meet; n != from; ) {
+            n = via[fwd][n];
+            path.push_back(n);
+        }
+
+        return path;
+    }
+
+    template <typename EdgeLengthType = long, Graph G,
+        CallableWithSignature<EdgeLengthType(uint64_t, uint64_t)> EdgeLength>
+    /// Dijkstra's shortest path between from and to
+    /// \tparam EdgeLengthType Return type of get_edge_length, the type of pathlengths
+    /// \param get_edge_length A function that gets to adjacent nodes and computes the length of the edge between them
+    /// \return Shortest path between nodes from and to, or std::nullopt, if no path is found
+    /// \remark Priority queue is a sorted vector -> linear insertion
+    ///         4097294 µs, 4.09729 seconds for 100000 iterations on 101x101 maze with >14000 solutions
     ///         (more than double speed)
-    static constexpr std::optional<PathType<DirectedGraph<D,N>>> search(
-        const DirectedGraph<D, N>& graph,
+    static constexpr std::optional<PathType<G>> search_sorted(
+        const G& graph,
         const uint64_t from, const uint64_t to,
         EdgeLength&& get_edge_length
         )
     {
-        std::cout << "Running Dijkstra\n";
-        using PQElm = PQElement<EdgeLengthType>;
-        constexpr uint64_t via_none = UINT64_MAX;
+        using Index = typename G::IndexType;
+        using PQElm = PQElement<EdgeLengthType, Index>;
+        constexpr Index via_none = std::numeric_limits<Index>::max();
 
         /* Priority queue is split into two sections:
          * |finished elements|priorityqueue|
          *                    ^ beginidx
          * finished nodes values are constant */
-        std::vector<PQElm> pqueue { { from, via_none, EdgeLengthType() } };
-        uint64_t beginidx = 0;
+        std::vector<PQElm> pqueue { { Index(from), via_none, EdgeLengthType() } };
+        Index beginidx = 0;
         pqueue.reserve(graph.size() / 12 + 1);
 
         std::vector<bool> added(graph.size(), 0);
@@ -68,7 +453,7 @@ public:
         bool path_found = false;
         while (beginidx < pqueue.size()) { /* while queue is not empty*/
             const PQElm element = pqueue.at(beginidx);
-            const uint64_t elmidx = beginidx;
+            const Index elmidx = beginidx;
             beginidx++;
 
             if (element.node == to) {
@@ -77,8 +462,8 @@ public:
             }
 
 
-            const Edges auto& edges = graph.edges(element.node);
-            for (const uint64_t e : edges) {
+            const EdgeView auto& edges = graph.edges(element.node);
+            for (const Index e : edges) {
                 if (added[e]) continue;
                 added[e] = true;
                 const EdgeLengthType elen = get_edge_length(element.node, e);
@@ -89,14 +474,14 @@ public:
 
         if (!path_found) return std::nullopt;
 
-        const uint64_t finished_end = beginidx;
+        const Index finished_end = beginidx;
         const PQElm& to_elm = pqueue.at(finished_end - 1);
 
-        PathType<DirectedGraph<D,N>> path = { to_elm.node };
+        PathType<G> path = { to_elm.node };
         path.reserve(graph.size() / 24 + 1);
 
         /* reconstruct path from last node, moving backward through via_elmidx */
-        uint64_t viaidx = to_elm.via_elmidx;
+        Index viaidx = to_elm.via_elmidx;
         while (viaidx != via_none) {
             const PQElm& elm = pqueue.at(viaidx);
             path.push_back(elm.node);
@@ -106,32 +491,24 @@ public:
         return path;
     }
 
-    template <typename D, uint64_t N>
-    static constexpr std::optional<PathType<DirectedGraph<D,N>>> search(
-        const DirectedGraph<D, N>& graph,
-        const uint64_t from, const uint64_t to
-        )
-    {
-        return Dijkstra::search<long>(graph, from, to, always_one);
-    }
-
-    template <typename EdgeLengthType = long, typename D, uint64_t N,
+    template <typename EdgeLengthType = long, Graph G,
         CallableWithSignature<EdgeLengthType(uint64_t, uint64_t)> EdgeLength>
     /// Dijkstra's shortest path between from and to
     /// \tparam EdgeLengthType Return type of get_edge_length, the type of pathlengths
     /// \param get_edge_length A function that gets to adjacent nodes and computes the length of the edge between them
     /// \return Shortest path between nodes from and to, or std::nullopt, if no path is found
     /// \remark 10977375 µs, 10.9774 seconds for 100000 iterations on 101x101 maze with >14000 solutions
-    static constexpr std::optional<PathType<DirectedGraph<D, N>>> search_deque(
-        const DirectedGraph<D, N>& graph,
+    static constexpr std::optional<PathType<G>> search_deque(
+        const G& graph,
         const uint64_t from, const uint64_t to,
         EdgeLength&& get_edge_length
     )
     {
-        using PQElm = PQElement<EdgeLengthType>;
+        using Index = typename G::IndexType;
+        using PQElm = PQElement<EdgeLengthType, Index>;
 
         /* index indicating no connection */
-        constexpr uint64_t via_none = UINT64_MAX;
+        constexpr Index via_none = std::numeric_limits<Index>::max();
 
         std::vector<bool> in_queue(graph.size(), 0);
         in_queue[from] = true;
@@ -140,7 +517,7 @@ public:
         std::vector<PQElm> finished;
 
         /* priority queue -> starts with the first node: from */
-        std::deque<PQElm> pqueue { { from, via_none, EdgeLengthType() }};
+        std::deque<PQElm> pqueue { { Index(from), via_none, EdgeLengthType() }};
 
         /* insert element into priority queue, sorted by current path length. */
         const auto insert_sorted = [&pqueue](PQElm&& elm) {
@@ -156,7 +533,7 @@ public:
             pqueue.pop_front();
 
             finished.push_back(elm);
-            const uint64_t elmidx = finished.size() - 1;
+            const Index elmidx = finished.size() - 1;
 
             if (elm.node == to) {
                 /* Found correct node, therefore shortest path. */
@@ -164,8 +541,8 @@ public:
                 break;
             }
 
-            const Edges auto & edges = graph.edges(elm.node);
-            for (uint64_t e : edges) {
+            const EdgeView auto & edges = graph.edges(elm.node);
+            for (Index e : edges) {
                 if (in_queue[e]) continue;
                 in_queue[e] = true;
 
@@ -179,8 +556,8 @@ public:
 
         /* reconstruct path back to from */
         const PQElm toelm = finished.back();
-        PathType<DirectedGraph<D, N>> path { toelm.node };
-        uint64_t viaidx = toelm.via_elmidx;
+        PathType<G> path { toelm.node };
+        Index viaidx = toelm.via_elmidx;
         while (viaidx != via_none) { /* until viaidx points to from */
             path.push_back(finished.at(viaidx).node);
             viaidx = finished.at(viaidx).via_elmidx;
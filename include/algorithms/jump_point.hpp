@@ -0,0 +1,331 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <span>
+#include <queue>
+#include <optional>
+#include <algorithm>
+#include <type_traits>
+#include <bit>
+#include <limits>
+#include <cassert>
+
+#include <maze.hpp>
+#include <bitmaze.hpp>
+#include <point.hpp>
+
+namespace mazes {
+/// Jump point search directly on the cells of a maze, without building a graph.
+/// In a maze with 4 directions, a jump goes straight along a corridor and stops at the cells where the
+/// corridor turns, forks or ends: the nodes of graph_from_maze. A corridor that only turns has a single
+/// way on, so the search keeps jumping around its corners, and only junctions enter the open set.
+/// Dead ends are dropped when they are reached. The corners of the path are found again by walking
+/// the corridors of the path once more, so the result is the path of turn points that a shortest path search
+/// on the MazeGraph returns, while only the junctions the search reaches are stored, nothing per cell or per node.
+/// On a BitMaze, horizontal jumps go through the row words, 64 cells at a time.
+class JumpPointSearch {
+public:
+    using Path = std::vector<Point>;
+
+    template <typename MazeType>
+    /// Shortest path between from and to, both path cells
+    /// \return turn points of a shortest path, ordered from to to from like the graph searches,
+    ///         or std::nullopt, if no path is found
+    static std::optional<Path> search(const MazeType& maze, const Point from, const Point to)
+    {
+        assert(maze.path_at(from) && maze.path_at(to));
+        const Ends ends { from, to };
+
+        /* state of a reached junction */
+        struct Visit {
+            uint64_t pathlen;
+            uint64_t parent; /* cell index of the previous junction, none for from */
+            Direction dir;   /* direction in which the corridor from parent leaves it */
+            bool closed;
+        };
+        /* open junction, ordered by pathlen + manhattan distance to to */
+        struct Open {
+            uint64_t estimate;
+            uint64_t pathlen;
+            uint64_t cell;
+            constexpr bool operator>(const Open& other) const noexcept { return estimate > other.estimate; }
+        };
+        constexpr uint64_t none = std::numeric_limits<uint64_t>::max();
+
+        CellTable<Visit> visits;
+        std::priority_queue<Open, std::vector<Open>, std::greater<>> open;
+        visits.try_emplace(maze.index_of(from), { 0, none, Direction::left, false });
+        open.push({ manhattan(from, to), 0, maze.index_of(from) });
+
+        bool path_found = false;
+        while (!open.empty()) {
+            const Open top = open.top();
+            open.pop();
+            Visit& visit = visits.at(top.cell);
+            /* stale entry of a node that was reached on a shorter path later */
+            if (visit.closed || top.pathlen != visit.pathlen) continue;
+            visit.closed = true;
+
+            const Point p = maze.point_of(top.cell);
+            if (p == to) {
+                path_found = true;
+                break;
+            }
+
+            /* manhattan distance is consistent -> a closed node is never reached on a shorter path */
+            for (const Direction dir : directions) {
+                if (!open_towards(maze, p, dir)) continue;
+                const std::optional<Corridor> corridor = follow(maze, p, dir, ends);
+                if (!corridor) continue;
+                const uint64_t pathlen = top.pathlen + corridor->len;
+                const uint64_t cell = maze.index_of(corridor->end);
+                const auto [reached, inserted] = visits.try_emplace(cell, { pathlen, top.cell, dir, false });
+                if (!inserted) {
+                    if (reached->closed || !(pathlen < reached->pathlen)) continue;
+                    *reached = { pathlen, top.cell, dir, false };
+                }
+                open.push({ pathlen + manhattan(corridor->end, to), pathlen, cell });
+            }
+        }
+
+        if (!path_found) return std::nullopt;
+
+        /* walk the corridors between the junctions again for their corners, last corridor first */
+        Path path { to };
+        for (uint64_t cell = maze.index_of(to); visits.at(cell).parent != none; cell = visits.at(cell).parent) {
+            const Visit& visit = visits.at(cell);
+            const uint64_t begin = path.size();
+            Point p = maze.point_of(visit.parent);
+            Direction dir = visit.dir;
+            while (true) {
+                p = jump(maze, p, dir, ends);
+                if (maze.index_of(p) == cell) break;
+                path.push_back(p);
+                dir = *way_on(maze, p, dir);
+            }
+            /* corners were added from parent towards cell */
+            std::reverse(path.begin() + begin, path.end());
+            path.push_back(maze.point_of(visit.parent));
+        }
+        return path;
+    }
+
+    template <typename MazeType>
+    /// Shortest path from the hole in the top row to the hole in the bottom row, the from and to
+    /// of a graph_from_maze graph (0 and size() - 1)
+    /// \return turn points of a shortest path, ordered from exit to entry, or std::nullopt, if no path is found
+    static std::optional<Path> search(const MazeType& maze)
+    {
+        const std::optional<Point> entry = hole(maze, 0), exit = hole(maze, maze.height - 1);
+        if (!entry || !exit) return std::nullopt;
+        return search(maze, *entry, *exit);
+    }
+
+private:
+    enum class Direction { left, right, up, down };
+    static constexpr std::array<Direction, 4> directions {
+        Direction::left, Direction::right, Direction::up, Direction::down };
+
+    /* from and to: a jump always stops on them */
+    using Ends = std::array<Point, 2>;
+
+    /// Hash table from cell index to the state of a reached junction, with open addressing:
+    /// no allocation per entry, and a lookup is mostly one cache line
+    template <typename Value>
+    class CellTable {
+    public:
+        CellTable() : slots_(64, { empty, {} }) { }
+
+        /// @return value of cell, and whether it was not in the table and was inserted as value
+        std::pair<Value*, bool> try_emplace(const uint64_t cell, const Value& value) {
+            if (2 * (size_ + 1) > slots_.size())
+                grow();
+            Slot& slot = find(cell);
+            if (slot.cell == cell) return { &slot.value, false };
+            slot = { cell, value };
+            size_++;
+            return { &slot.value, true };
+        }
+
+        /// @return value of cell, which must be in the table
+        Value& at(const uint64_t cell) noexcept {
+            Slot& slot = find(cell);
+            assert(slot.cell == cell);
+            return slot.value;
+        }
+
+    private:
+        static constexpr uint64_t empty = std::numeric_limits<uint64_t>::max();
+
+        struct Slot {
+            uint64_t cell;
+            Value value;
+        };
+
+        /// @return slot of cell, or the empty slot where it belongs
+        Slot& find(const uint64_t cell) noexcept {
+            const uint64_t mask = slots_.size() - 1;
+            /* fibonacci hashing: neighbouring cells spread over the table */
+            uint64_t i = (cell * 0x9E3779B97F4A7C15ull) >> (64 - std::countr_zero(slots_.size()));
+            while (slots_[i].cell != cell && slots_[i].cell != empty)
+                i = (i + 1) & mask;
+            return slots_[i];
+        }
+
+        void grow() {
+            std::vector<Slot> old(slots_.size() * 2, { empty, {} });
+            std::swap(old, slots_);
+            for (const Slot& slot : old)
+                if (slot.cell != empty)
+                    find(slot.cell) = slot;
+        }
+
+        std::vector<Slot> slots_; /* power of two, at most half full */
+        uint64_t size_ = 0;
+    };
+
+    /// Corridor from a junction to the next junction, dead end, from or to
+    struct Corridor {
+        Point end;
+        uint64_t len; /* in cells */
+    };
+
+    static constexpr uint64_t manhattan(const Point a, const Point b) noexcept {
+        return uint64_t(a.x > b.x ? a.x - b.x : b.x - a.x) + (a.y > b.y ? a.y - b.y : b.y - a.y);
+    }
+
+    static constexpr Direction opposite(const Direction dir) noexcept {
+        switch (dir) {
+            case Direction::left:  return Direction::right;
+            case Direction::right: return Direction::left;
+            case Direction::up:    return Direction::down;
+            case Direction::down:  return Direction::up;
+        }
+        return dir;
+    }
+
+    static constexpr Point step(const Point p, const Direction dir) noexcept {
+        switch (dir) {
+            case Direction::left:  return { p.x - 1, p.y };
+            case Direction::right: return { p.x + 1, p.y };
+            case Direction::up:    return { p.x, p.y - 1 };
+            case Direction::down:  return { p.x, p.y + 1 };
+        }
+        return p;
+    }
+
+    /// @return whether the neighbour of p in direction dir is a path cell. Outside the maze is wall
+    template <typename MazeType>
+    static constexpr bool open_towards(const MazeType& maze, const Point p, const Direction dir) noexcept {
+        switch (dir) {
+            case Direction::left:  return p.x > 0 && maze.path_at(step(p, dir));
+            case Direction::right: return p.x + 1 < maze.width && maze.path_at(step(p, dir));
+            case Direction::up:    return p.y > 0 && maze.path_at(step(p, dir));
+            case Direction::down:  return p.y + 1 < maze.height && maze.path_at(step(p, dir));
+        }
+        return false;
+    }
+
+    /// @return the only way out of p other than back against dir, std::nullopt at dead ends and junctions
+    template <typename MazeType>
+    static std::optional<Direction> way_on(const MazeType& maze, const Point p, const Direction dir) noexcept {
+        std::optional<Direction> way;
+        for (const Direction d : directions) {
+            if (d == opposite(dir) || !open_towards(maze, p, d)) continue;
+            if (way) return std::nullopt;
+            way = d;
+        }
+        return way;
+    }
+
+    /// @return first path cell in the top or bottom row, not counting the corners, as add_entry and add_exit
+    template <typename MazeType>
+    static std::optional<Point> hole(const MazeType& maze, const uint32_t y) {
+        for (uint32_t x = 1; x + 1 < maze.width; x++)
+            if (maze.path_at({ x, y }))
+                return Point { x, y };
+        return std::nullopt;
+    }
+
+    /// @brief Follow the corridor from p in direction dir, around its corners
+    /// @return the junction, from or to at its end, or std::nullopt if it is a dead end
+    template <typename MazeType>
+    static std::optional<Corridor> follow(const MazeType& maze, Point p, Direction dir, const Ends& ends) noexcept {
+        uint64_t len = 0;
+        while (true) {
+            const Point q = jump(maze, p, dir, ends);
+            len += manhattan(p, q);
+            if (q == ends[0] || q == ends[1]) return Corridor { q, len };
+
+            /* corner: one way on. Otherwise a junction or a dead end, counting the way back */
+            uint32_t ways = 0;
+            for (const Direction d : directions)
+                ways += open_towards(maze, q, d);
+            if (ways == 1) return std::nullopt;
+            if (ways > 2) return Corridor { q, len };
+            p = q;
+            dir = *way_on(maze, q, dir);
+        }
+    }
+
+    /// @brief Go straight from p in direction dir, whose neighbour is a path cell, to the next turn point:
+    ///        the first cell that is not a straight pass-through (a node of graph_from_maze), or one of ends
+    template <typename MazeType>
+    static Point jump(const MazeType& maze, const Point p, const Direction dir, const Ends& ends) noexcept {
+        const bool horizontal = dir == Direction::left || dir == Direction::right;
+        if constexpr (std::is_same_v<MazeType, BitMaze>) {
+            if (horizontal && p.y > 0 && p.y + 1 < maze.height)
+                return jump_words(maze, p, dir == Direction::right, ends);
+        }
+
+        Point q = step(p, dir);
+        while (q != ends[0] && q != ends[1]) {
+            /* top and bottom row only hold entry and exit */
+            if (q.y == 0 || q.y + 1 == maze.height) break;
+            const bool sideways = horizontal
+                ? maze.path_at({ q.x, q.y - 1 }) || maze.path_at({ q.x, q.y + 1 })
+                : open_towards(maze, q, Direction::left) || open_towards(maze, q, Direction::right);
+            if (sideways || !open_towards(maze, q, dir)) break;
+            q = step(q, dir);
+        }
+        return q;
+    }
+
+    /// @brief jump along row p.y (0 < p.y < height - 1) on the words of a BitMaze: a cell stops the jump
+    ///        if it has a path above or below, or a wall ahead, 64 cells per step
+    static Point jump_words(const BitMaze& maze, const Point p, const bool right, const Ends& ends) noexcept {
+        using Word = BitMaze::Word;
+        constexpr uint32_t bits = BitMaze::word_bits;
+        const std::span<const Word> row = maze.row(p.y), above = maze.row(p.y - 1), below = maze.row(p.y + 1);
+
+        /* stop cells of word w, padding bits are wall and stop */
+        const auto stops = [&](const uint32_t w) -> Word {
+            const Word ahead = right
+                ? (row[w] >> 1) | (w + 1 < maze.stride ? row[w + 1] << (bits - 1) : 0)
+                : (row[w] << 1) | (w > 0 ? row[w - 1] >> (bits - 1) : 0);
+            Word s = above[w] | below[w] | ~ahead;
+            for (const Point end : ends)
+                if (end.y == p.y && end.x / bits == w)
+                    s |= Word(1) << (end.x % bits);
+            return s;
+        };
+
+        /* the neighbour of p is a path cell, and every cell up to the first stop continues the corridor */
+        uint32_t w = p.x / bits;
+        if (right) {
+            const uint32_t start = p.x % bits + 1;
+            Word s = start < bits ? stops(w) & (~Word(0) << start) : 0;
+            while (s == 0)
+                s = stops(++w);
+            return { w * bits + uint32_t(std::countr_zero(s)), p.y };
+        }
+        const uint32_t start = p.x % bits;
+        Word s = start > 0 ? stops(w) & (~Word(0) >> (bits - start)) : 0;
+        while (s == 0)
+            s = stops(--w);
+        return { w * bits + (bits - 1 - uint32_t(std::countl_zero(s))), p.y };
+    }
+};
+} // namespace mazes
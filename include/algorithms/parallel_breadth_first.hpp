@@ -0,0 +1,326 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <optional>
+#include <atomic>
+#include <barrier>
+#include <thread>
+#include <algorithm>
+#include <limits>
+#include <bit>
+#include <cassert>
+#include <concepts>
+
+#include <graph.hpp>
+#include <path_type.hpp>
+
+namespace mazes {
+
+/// Breadth first tree of the nodes reachable from a root, as built by ParallelBreadthFirst::sweep
+/// \tparam Index type of node indices
+template <std::unsigned_integral Index>
+struct BreadthFirstTree {
+    static constexpr Index unreached = std::numeric_limits<Index>::max();
+
+    std::vector<Index> parent;     /* node each node was discovered from, the root itself, unreached if not reached */
+    std::vector<Index> queue;      /* reached nodes, in the order BreadthFirst::search dequeues them */
+    std::vector<uint64_t> levels;  /* nodes at distance d from the root: queue[levels[d] .. levels[d + 1]) */
+
+    bool reached(const uint64_t node) const noexcept { return parent[node] != unreached; }
+
+    /// @return distance of the farthest reached node from the root
+    uint64_t depth() const noexcept { return levels.size() - 2; }
+
+    /// @return path from the root to node along the tree, ordered from node to the root like
+    ///         BreadthFirst::search, or std::nullopt, if node was not reached
+    std::optional<std::vector<Index>> path(const uint64_t node) const {
+        if (!reached(node)) return std::nullopt;
+        std::vector<Index> out { Index(node) };
+        while (parent[out.back()] != out.back())
+            out.push_back(parent[out.back()]);
+        return out;
+    }
+};
+
+/// Level-synchronous parallel breadth first search that switches direction per level:
+/// top-down, the frontier pushes to its unvisited neighbours, and bottom-up, every unvisited node pulls
+/// from a neighbour in the frontier (a bitset), which is cheaper once the frontier holds a large share of the
+/// remaining edges (Beamer et al., alpha = 14, beta = 24).
+/// The parent of a node is its neighbour in the previous level that comes first in the queue of the serial
+/// BreadthFirst::search, the one that discovers it there: top-down it is claimed with an atomic minimum,
+/// bottom-up every frontier neighbour is compared. The queue positions of a new level are then counted
+/// per frontier node and prefix summed, so the parent tree, and so every path, is that of BreadthFirst::search.
+/// Levels with a frontier smaller than min_parallel_frontier are expanded serially without synchronisation,
+/// so the long thin frontiers of mazes, which have one level per step of their longest corridor, cost no barriers.
+/// \remark Graph must be symmetric (every edge has its reverse, as created by connect) for bottom-up levels
+class ParallelBreadthFirst {
+public:
+    /* default smallest frontier that is expanded by all threads */
+    static constexpr uint64_t default_min_parallel_frontier = 1 << 14;
+    /* switch to bottom-up when the frontier has more than 1/alpha of the unexplored edges,
+       back to top-down when it has less than 1/beta of the nodes */
+    static constexpr uint64_t alpha = 14, beta = 24;
+
+    template <Graph G>
+    /// Breadth first search from from to every reachable node
+    /// \param nthreads number of threads, 0 for one per hardware thread
+    /// \param min_parallel_frontier smallest frontier that is expanded by all threads, smaller ones serially
+    /// \return tree of all nodes reachable from from
+    static BreadthFirstTree<typename G::IndexType> sweep(
+        const G& graph,
+        const uint64_t from,
+        const uint32_t nthreads = 0,
+        const uint64_t min_parallel_frontier = default_min_parallel_frontier
+        )
+    {
+        return Sweep<G>(graph, from, Sweep<G>::none, nthreads, min_parallel_frontier).run();
+    }
+
+    template <Graph G>
+    /// Breadth first search from from to to, which stops after the level of to
+    /// \param nthreads number of threads, 0 for one per hardware thread
+    /// \param min_parallel_frontier smallest frontier that is expanded by all threads, smaller ones serially
+    /// \return Path with the fewest edges, the path of BreadthFirst::search, ordered from to to from,
+    ///         or std::nullopt, if no path is found
+    static std::optional<PathType<G>> search(
+        const G& graph,
+        const uint64_t from, const uint64_t to,
+        const uint32_t nthreads = 0,
+        const uint64_t min_parallel_frontier = default_min_parallel_frontier
+        )
+    {
+        const BreadthFirstTree<typename G::IndexType> tree =
+            Sweep<G>(graph, from, to, nthreads, min_parallel_frontier).run();
+        const auto path = tree.path(to);
+        if (!path) return std::nullopt;
+        return PathType<G>(path->begin(), path->end());
+    }
+
+private:
+    template <Graph G>
+    class Sweep {
+    public:
+        using Index = typename G::IndexType;
+        static constexpr Index none = std::numeric_limits<Index>::max();
+
+        Sweep(const G& graph, const uint64_t from, const Index to, uint32_t nthreads, const uint64_t min_parallel_frontier)
+            : graph_{graph}, n_{graph.size()}, to_{to},
+              nthreads_{nthreads == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : nthreads},
+              min_parallel_frontier_{min_parallel_frontier},
+              parent_pos_(n_, none), pos_(n_, none), queue_(n_),
+              visited_((n_ + 63) / 64, 0), workers_(nthreads_)
+        {
+            assert(from < n_ && n_ < none);
+            queue_[0] = Index(from);
+            pos_[from] = 0;
+            parent_pos_[from] = 0;
+            set(visited_, from);
+            levels_ = { 0, 1 };
+            for (uint64_t v = 0; v < n_; v++)
+                unexplored_edges_ += graph.edges(v).size();
+            frontier_edges_ = graph.edges(from).size();
+            unexplored_edges_ -= frontier_edges_;
+        }
+
+        BreadthFirstTree<Index> run() {
+            advance();
+            if (!done_) {
+                std::barrier sync(nthreads_, [this]() noexcept { complete_phase(); });
+                const auto worker = [&](const uint32_t t) {
+                    while (!done_) {
+                        if (top_down_) expand_top_down(t); else expand_bottom_up(t);
+                        sync.arrive_and_wait();
+                        number_children(t, false);
+                        sync.arrive_and_wait();
+                        number_children(t, true);
+                        sync.arrive_and_wait();
+                    }
+                };
+                std::vector<std::thread> threads;
+                threads.reserve(nthreads_ - 1);
+                for (uint32_t t = 1; t < nthreads_; t++)
+                    threads.emplace_back(worker, t);
+                worker(0);
+                for (std::thread& t : threads)
+                    t.join();
+            }
+
+            /* parents from queue positions to nodes, in place */
+            for (uint64_t v = 0; v < n_; v++)
+                if (parent_pos_[v] != none)
+                    parent_pos_[v] = queue_[parent_pos_[v]];
+            queue_.resize(levels_.back());
+            /* the sweep ends with an empty level */
+            if (levels_.size() > 2 && levels_.back() == levels_[levels_.size() - 2])
+                levels_.pop_back();
+            return { std::move(parent_pos_), std::move(queue_), std::move(levels_) };
+        }
+
+    private:
+        static bool test(const std::vector<uint64_t>& bits, const uint64_t i) noexcept {
+            return (bits[i / 64] >> (i % 64)) & 1;
+        }
+        static void set(std::vector<uint64_t>& bits, const uint64_t i) noexcept {
+            bits[i / 64] |= uint64_t(1) << (i % 64);
+        }
+
+        uint64_t frontier_begin() const noexcept { return levels_[levels_.size() - 2]; }
+        uint64_t frontier_end() const noexcept { return levels_.back(); }
+
+        /// @return range [begin, end) of [0, size) of thread t
+        std::pair<uint64_t, uint64_t> chunk(const uint64_t size, const uint32_t t) const noexcept {
+            return { size * t / nthreads_, size * (t + 1) / nthreads_ };
+        }
+
+        bool finished() const noexcept {
+            return frontier_begin() == frontier_end() || (to_ != none && test(visited_, to_));
+        }
+
+        /// @brief Expand the frontier serially, exactly as BreadthFirst::search
+        void serial_level() {
+            uint64_t tail = frontier_end();
+            frontier_edges_ = 0;
+            for (uint64_t p = frontier_begin(); p < frontier_end(); p++) {
+                for (const Index e : graph_.edges(queue_[p])) {
+                    if (test(visited_, e)) continue;
+                    set(visited_, e);
+                    parent_pos_[e] = p;
+                    pos_[e] = tail;
+                    queue_[tail++] = e;
+                    frontier_edges_ += graph_.edges(e).size();
+                }
+            }
+            levels_.push_back(tail);
+            unexplored_edges_ -= frontier_edges_;
+        }
+
+        /// @brief Expand small levels serially until the search is done or the next level is expanded in parallel,
+        ///        and choose its direction
+        void advance() {
+            while (!finished()) {
+                const uint64_t size = frontier_end() - frontier_begin();
+                if (nthreads_ == 1 || size < min_parallel_frontier_) {
+                    serial_level();
+                    continue;
+                }
+
+                if (top_down_ && frontier_edges_ > unexplored_edges_ / alpha)
+                    top_down_ = false;
+                else if (!top_down_ && size < n_ / beta)
+                    top_down_ = true;
+
+                if (!top_down_) {
+                    frontier_bits_.assign(visited_.size(), 0);
+                    for (uint64_t p = frontier_begin(); p < frontier_end(); p++)
+                        set(frontier_bits_, queue_[p]);
+                }
+                return;
+            }
+            done_ = true;
+        }
+
+        /// @brief Serial step between the parallel phases of a level, on the last thread to arrive
+        void complete_phase() {
+            if (phase_ == 1) {
+                /* exclusive prefix sum: where the children of each thread's part of the frontier go */
+                uint64_t start = frontier_end();
+                for (Worker& w : workers_) {
+                    w.start = start;
+                    start += w.count;
+                }
+            } else if (phase_ == 2) {
+                levels_.push_back(workers_.back().start + workers_.back().count);
+                frontier_edges_ = 0;
+                for (const Worker& w : workers_)
+                    frontier_edges_ += w.edges;
+                unexplored_edges_ -= frontier_edges_;
+                advance();
+            }
+            phase_ = (phase_ + 1) % 3;
+        }
+
+        /// @brief Offer every frontier node as parent to its unvisited neighbours, the first in the queue wins
+        void expand_top_down(const uint32_t t) {
+            const auto [begin, end] = chunk(frontier_end() - frontier_begin(), t);
+            for (uint64_t p = frontier_begin() + begin; p < frontier_begin() + end; p++) {
+                for (const Index e : graph_.edges(queue_[p])) {
+                    if (test(visited_, e)) continue;
+                    std::atomic_ref<Index> slot(parent_pos_[e]);
+                    Index current = slot.load(std::memory_order_relaxed);
+                    while (p < current && !slot.compare_exchange_weak(current, Index(p), std::memory_order_relaxed)) { }
+                }
+            }
+        }
+
+        /// @brief Let every unvisited node of thread t's words pick its first neighbour in the frontier
+        void expand_bottom_up(const uint32_t t) {
+            const auto [begin, end] = chunk(visited_.size(), t);
+            for (uint64_t w = begin; w < end; w++) {
+                for (uint64_t unvisited = ~visited_[w]; unvisited != 0; unvisited &= unvisited - 1) {
+                    const uint64_t v = w * 64 + std::countr_zero(unvisited);
+                    if (v >= n_) break;
+                    Index best = none;
+                    for (const Index u : graph_.edges(v))
+                        if (test(frontier_bits_, u))
+                            best = std::min(best, pos_[u]);
+                    parent_pos_[v] = best;
+                }
+            }
+        }
+
+        /// @brief Count (place == false), or put into the queue (place == true), the children of
+        ///        thread t's part of the frontier, in the order of the serial search
+        void number_children(const uint32_t t, const bool place) {
+            Worker& worker = workers_[t];
+            uint64_t tail = worker.start;
+            uint64_t count = 0, edges = 0;
+            const auto [begin, end] = chunk(frontier_end() - frontier_begin(), t);
+            for (uint64_t p = frontier_begin() + begin; p < frontier_begin() + end; p++) {
+                const EdgeView auto& es = graph_.edges(queue_[p]);
+                for (uint64_t i = 0; i < es.size(); i++) {
+                    const Index e = es[i];
+                    /* nodes of earlier levels have parents before the frontier -> e is new */
+                    if (parent_pos_[e] != p) continue;
+                    if (std::find(es.begin(), es.begin() + i, e) != es.begin() + i) continue;
+                    count++;
+                    if (!place) continue;
+                    std::atomic_ref<uint64_t>(visited_[e / 64]).fetch_or(uint64_t(1) << (e % 64), std::memory_order_relaxed);
+                    pos_[e] = tail;
+                    queue_[tail++] = e;
+                    edges += graph_.edges(e).size();
+                }
+            }
+            worker.count = count;
+            worker.edges = edges;
+        }
+
+        /* own cache line per thread: all threads write theirs in the same phase */
+        struct alignas(64) Worker {
+            uint64_t count = 0; /* children of the thread's part of the frontier */
+            uint64_t start = 0; /* queue position of its first child */
+            uint64_t edges = 0; /* edges of its children */
+        };
+
+        const G& graph_;
+        const uint64_t n_;
+        const Index to_;
+        const uint32_t nthreads_;
+        const uint64_t min_parallel_frontier_;
+
+        std::vector<Index> parent_pos_; /* queue position of the parent of each node, the root's is 0 */
+        std::vector<Index> pos_;        /* queue position of each node */
+        std::vector<Index> queue_;      /* nodes in the order of the serial search */
+        std::vector<uint64_t> levels_;
+        std::vector<uint64_t> visited_;       /* bitset */
+        std::vector<uint64_t> frontier_bits_; /* bitset of the frontier, for bottom-up levels */
+        std::vector<Worker> workers_;
+
+        uint64_t unexplored_edges_ = 0; /* edges of unvisited nodes */
+        uint64_t frontier_edges_ = 0;   /* edges of the frontier nodes */
+        bool top_down_ = true;
+        bool done_ = false;
+        uint32_t phase_ = 0;
+    };
+};
+} // namespace mazes
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <cassert>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+
+#include <maze.hpp>
+#include <point.hpp>
+
+namespace mazes {
+/// Maze with one bit per cell: 1 is path, 0 is wall.
+/// Every row starts at a new 64 bit word (stride words per row), cell x of a row is bit x % 64
+/// of word x / 64. Padding bits after the last cell of a row are wall.
+/// Only stores path and wall, at() returns Maze::path or Maze::wall.
+/// The words are either owned, or a view of an external buffer (e.g. a mapped file) kept alive by an owner.
+struct BitMaze {
+    using Word = uint64_t;
+    static constexpr uint32_t word_bits = 64;
+
+    const uint32_t width, height;
+    const uint32_t stride; /* words per row */
+
+    /// @return number of words per row for a maze of given width
+    static constexpr uint32_t stride_of(uint32_t w) noexcept { return (w + word_bits - 1) / word_bits; }
+
+    /// @brief Maze of only walls
+    BitMaze(uint32_t w, uint32_t h)
+            : width { w }, height { h }, stride { stride_of(w) },
+              owned_(uint64_t(stride) * h, 0), owner_ {}, words_ { owned_.data() }
+    { }
+
+    /// @brief View of external storage, no copy
+    /// @param words stride_of(w) * h words in the layout of BitMaze, padding bits 0
+    /// @param owner keeps words alive as long as the maze or a copy of the owner lives
+    BitMaze(uint32_t w, uint32_t h, Word* words, std::shared_ptr<void> owner) noexcept
+            : width { w }, height { h }, stride { stride_of(w) },
+              owned_ {}, owner_ { std::move(owner) }, words_ { words }
+    { }
+
+    /// @brief Deep copy: the copy always owns its words
+    BitMaze(const BitMaze& other)
+            : width { other.width }, height { other.height }, stride { other.stride },
+              owned_(other.words().begin(), other.words().end()), owner_ {}, words_ { owned_.data() }
+    { }
+
+    /* moving a vector keeps its buffer -> words_ stays valid */
+    BitMaze(BitMaze&& other) noexcept = default;
+
+    /// @param beg, end w * h cells in row order, Maze::path or Maze::wall
+    template <typename Ite>
+    BitMaze(uint32_t w, uint32_t h, Ite beg, Ite end)
+            : BitMaze(w, h)
+    {
+        uint64_t i = 0;
+        for (Ite it = beg; it != end; ++it, ++i)
+            if (*it == Maze::path)
+                set_path(i);
+        assert(i == uint64_t(w) * h);
+    }
+
+    BitMaze(uint32_t w, uint32_t h, std::initializer_list<uint8_t> lst)
+            : BitMaze(w, h, lst.begin(), lst.end())
+    { }
+
+    explicit BitMaze(const Maze& maze)
+            : BitMaze(maze.width, maze.height)
+    {
+        for (uint64_t i = 0; i < maze.size(); i++)
+            if (maze.path_at(i))
+                set_path(i);
+    }
+
+    constexpr uint64_t index_of(Point p) const noexcept
+    {
+        return p.x + uint64_t(p.y) * width;
+    }
+
+    constexpr Point point_of(uint64_t idx) const noexcept
+    {
+        return {
+                uint32_t(idx % width),
+                uint32_t(idx / width)
+        };
+    }
+
+    /// @return Maze::path or Maze::wall
+    constexpr uint8_t at(uint64_t i) const noexcept { return at(point_of(i)); }
+
+    /// @return Maze::path or Maze::wall
+    constexpr uint8_t at(Point p) const noexcept { return path_at(p) ? Maze::path : Maze::wall; }
+
+    constexpr bool path_at(uint64_t i) const noexcept { return path_at(point_of(i)); };
+
+    constexpr bool path_at(Point p) const noexcept
+    {
+        assert(p.x < width && p.y < height);
+        return (words_[word_of(p)] >> (p.x % word_bits)) & 1;
+    };
+
+    /// @param value Maze::path makes the cell a path, anything else a wall
+    constexpr void set(Point p, uint8_t value) noexcept
+    {
+        assert(p.x < width && p.y < height);
+        const Word bit = Word(1) << (p.x % word_bits);
+        if (value == Maze::path)
+            words_[word_of(p)] |= bit;
+        else
+            words_[word_of(p)] &= ~bit;
+    }
+
+    constexpr void set(uint64_t i, uint8_t value) noexcept { set(point_of(i), value); }
+
+    constexpr uint64_t size() const noexcept { return uint64_t(width) * height; };
+
+    /// @return the stride words of row y, 64 cells per word
+    constexpr std::span<const Word> row(uint32_t y) const noexcept
+    {
+        assert(y < height);
+        return { words_ + uint64_t(y) * stride, stride };
+    }
+
+    /// @return the stride words of row y, 64 cells per word. Padding bits must stay 0
+    constexpr std::span<Word> row(uint32_t y) noexcept
+    {
+        assert(y < height);
+        return { words_ + uint64_t(y) * stride, stride };
+    }
+
+    /// @return all rows, stride words each
+    constexpr std::span<const Word> words() const noexcept { return { words_, uint64_t(stride) * height }; }
+
+    /// @return whether the words are a view of external storage
+    constexpr bool is_view() const noexcept { return words_ != owned_.data(); }
+
+private:
+    constexpr uint64_t word_of(Point p) const noexcept
+    {
+        return uint64_t(p.y) * stride + p.x / word_bits;
+    }
+
+    constexpr void set_path(uint64_t i) noexcept
+    {
+        const Point p = point_of(i);
+        words_[word_of(p)] |= Word(1) << (p.x % word_bits);
+    }
+
+    std::vector<Word> owned_;     /* storage if the maze owns its words */
+    std::shared_ptr<void> owner_; /* keeps external storage alive */
+    Word* words_;                 /* owned_.data() or external storage */
+};
+}; // namespace mazes
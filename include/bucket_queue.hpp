@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <bit>
+#include <algorithm>
+#include <limits>
+#include <cassert>
+#include <concepts>
+#include <type_traits>
+
+namespace mazes {
+
+/// Priority queues for monotone integer keys: the popped keys never decrease, and
+/// every pushed key is at least the last popped key (which is the case for Dijkstra).
+/// Neither queue supports decrease-key, a node is pushed again instead and the caller
+/// skips the stale entries.
+
+/// Dial's bucket queue: circular array of max_step + 1 buckets.
+/// Keys in the queue are always within [current, current + max_step] -> O(1) push, amortized O(1) pop.
+/// \tparam Key non-negative integral priority
+/// \tparam Value data stored with each key
+template <std::integral Key, typename Value>
+class DialQueue {
+public:
+    struct Element {
+        Key key;
+        Value value;
+    };
+
+    /// @param max_step largest difference between a pushed key and the last popped key
+    constexpr explicit DialQueue(const uint64_t max_step)
+        : buckets_(max_step + 1), current_{0}, size_{0} { };
+
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr uint64_t size() const noexcept { return size_; }
+
+    constexpr void push(const Key key, const Value& value) {
+        assert(key >= current_ && uint64_t(key - current_) < buckets_.size());
+        buckets_[uint64_t(key) % buckets_.size()].push_back(value);
+        size_++;
+    }
+
+    /// @brief remove an element with the smallest key
+    constexpr Element pop() noexcept {
+        assert(!empty());
+        /* advance to the next non-empty bucket, at most max_step steps */
+        while (bucket().empty())
+            current_++;
+
+        const Value value = bucket().back();
+        bucket().pop_back();
+        size_--;
+        return { current_, value };
+    }
+
+private:
+    constexpr std::vector<Value>& bucket() noexcept {
+        return buckets_[uint64_t(current_) % buckets_.size()];
+    }
+
+    std::vector<std::vector<Value>> buckets_;
+    Key current_; /* key of the last popped element */
+    uint64_t size_;
+};
+
+/// Radix heap: bucket i holds keys that differ from the last popped key in bit i - 1 as the highest bit.
+/// Each element moves to a lower bucket at most bit-width times -> amortized O(log C) per element,
+/// independent of the number of elements, and no comparisons between keys in the same bucket.
+/// \tparam Key non-negative integral priority
+/// \tparam Value data stored with each key
+template <std::integral Key, typename Value>
+class RadixHeap {
+    using UKey = std::make_unsigned_t<Key>;
+    static constexpr uint64_t nbuckets = std::numeric_limits<UKey>::digits + 1;
+
+public:
+    struct Element {
+        Key key;
+        Value value;
+    };
+
+    constexpr RadixHeap()
+        : buckets_{}, last_{0}, size_{0} { };
+
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr uint64_t size() const noexcept { return size_; }
+
+    /// @brief Remove all elements and start again at key 0. Keeps the memory of the buckets
+    constexpr void clear() noexcept {
+        for (std::vector<Element>& bucket : buckets_)
+            bucket.clear();
+        last_ = 0;
+        size_ = 0;
+    }
+
+    constexpr void push(const Key key, const Value& value) {
+        assert(UKey(key) >= last_ && "keys must be monotone");
+        buckets_[bucket_of(UKey(key))].push_back({ key, value });
+        size_++;
+    }
+
+    /// @brief remove an element with the smallest key
+    constexpr Element pop() noexcept {
+        assert(!empty());
+        if (buckets_[0].empty()) {
+            /* first non-empty bucket: its minimum becomes the new last key,
+               and all its elements move to lower buckets */
+            uint64_t i = 1;
+            while (buckets_[i].empty()) i++;
+
+            UKey new_last = std::numeric_limits<UKey>::max();
+            for (const Element& elm : buckets_[i])
+                new_last = std::min(new_last, UKey(elm.key));
+            last_ = new_last;
+
+            for (const Element& elm : buckets_[i])
+                buckets_[bucket_of(UKey(elm.key))].push_back(elm);
+            buckets_[i].clear();
+        }
+
+        const Element elm = buckets_[0].back();
+        buckets_[0].pop_back();
+        size_--;
+        return elm;
+    }
+
+private:
+    constexpr uint64_t bucket_of(const UKey key) const noexcept {
+        return std::bit_width(UKey(key ^ last_));
+    }
+
+    std::array<std::vector<Element>, nbuckets> buckets_;
+    UKey last_; /* key of the last popped element */
+    uint64_t size_;
+};
+
+} // namespace mazes
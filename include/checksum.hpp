@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <bit>
+
+namespace mazes {
+
+/// @brief Final mix of a 64 bit value (splitmix64): every input bit affects every output bit
+constexpr uint64_t mix64(uint64_t x) noexcept {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EB;
+    x ^= x >> 31;
+    return x;
+}
+
+/// @brief Fast non-cryptographic hash of a sequence of words, to detect corrupt or changed data
+/// @param seed start value, e.g. to include the dimensions of the data
+constexpr uint64_t checksum(const std::span<const uint64_t> words, const uint64_t seed = 0) noexcept {
+    uint64_t h = mix64(seed ^ words.size());
+    for (const uint64_t w : words)
+        h = std::rotl(h ^ w, 29) * 0x9E3779B97F4A7C15;
+    return mix64(h);
+}
+
+} // namespace mazes
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <limits>
+#include <optional>
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+
+#include <graph.hpp>
+#include <csrgraph.hpp>
+#include <weighted_graph.hpp>
+#include <callable.hpp>
+
+namespace mazes {
+
+/// Graph of the junctions and terminals of an undirected graph, as built by contract():
+/// dead-end branches are removed and each chain of degree-2 nodes is one edge, which stores the chain's
+/// length and its interior nodes. Is a WeightedGraph, so every algorithm searches it directly,
+/// Dijkstra and AStar without an edge length callback, and expand() turns its paths back into paths of the original graph.
+/// \tparam D Datatype stored in each node, copied from the original node
+/// \tparam Index Type of node indices, contracted and original
+/// \tparam Length Type of edge lengths
+template <typename D, std::unsigned_integral Index, typename Length>
+class ContractedGraph {
+public:
+    using IndexType = Index;
+    using LengthType = Length;
+    using EdgesType = typename CsrGraph<D, Index>::EdgesType;
+    using Path = std::vector<Index>;
+
+    ContractedGraph(
+            CsrGraph<D, Index> graph,
+            std::vector<Length> lengths,
+            std::vector<Index> original,
+            std::vector<Index> contracted,
+            std::vector<uint64_t> chain_offsets,
+            std::vector<Index> chain_nodes)
+            : graph_{std::move(graph)}, lengths_{std::move(lengths)},
+              original_{std::move(original)}, contracted_{std::move(contracted)},
+              chain_offsets_{std::move(chain_offsets)}, chain_nodes_{std::move(chain_nodes)}
+    {
+        assert(lengths_.size() == graph_.neighbors().size());
+        assert(chain_offsets_.size() == lengths_.size() + 1);
+    }
+
+    /// @return data of node at given index
+    constexpr const D& node(const Index node_index) const noexcept { return graph_.node(node_index); }
+
+    /// @return list of outgoing edges from node at node_index
+    constexpr EdgesType edges(const Index node_index) const noexcept { return graph_.edges(node_index); }
+
+    /// @return number of nodes
+    constexpr uint64_t size() const noexcept { return graph_.size(); }
+
+    /// @return the contracted graph itself
+    constexpr const CsrGraph<D, Index>& graph() const noexcept { return graph_; }
+
+    /// @return length of the edge from from to to, the sum of the lengths along its chain
+    constexpr Length length(const uint64_t from, const uint64_t to) const noexcept {
+        return lengths_[edge_of(from, to)];
+    }
+
+    /// @return edge lengths, in the order of graph().neighbors()
+    constexpr std::span<const Length> lengths() const noexcept { return lengths_; }
+
+    /// @return lengths of the outgoing edges of node_index, in the order of edges(node_index)
+    constexpr std::span<const Length> edge_lengths(const Index node_index) const noexcept {
+        return { lengths_.data() + graph_.offsets()[node_index], lengths_.data() + graph_.offsets()[node_index + 1] };
+    }
+
+    /// @return index in the original graph of node
+    constexpr Index original(const uint64_t node) const noexcept { return original_[node]; }
+
+    /// @return index in the contracted graph of original node,
+    ///         or std::nullopt if it was removed or is inside a chain
+    constexpr std::optional<Index> contracted(const uint64_t original_node) const noexcept {
+        const Index node = contracted_[original_node];
+        if (node == removed) return std::nullopt;
+        return node;
+    }
+
+    /// @return the original nodes strictly between from and to on the edge from from to to, in order
+    constexpr std::span<const Index> chain(const uint64_t from, const uint64_t to) const noexcept {
+        const uint64_t e = edge_of(from, to);
+        return { chain_nodes_.data() + chain_offsets_[e], chain_nodes_.data() + chain_offsets_[e + 1] };
+    }
+
+    /// @brief Turn a path of the contracted graph into the path of original nodes it stands for
+    /// @param path consecutive nodes connected by edges, in any direction (e.g. Dijkstra's to to from)
+    Path expand(const std::span<const Index> path) const {
+        Path out;
+        for (uint64_t i = 0; i < path.size(); i++) {
+            out.push_back(original_[path[i]]);
+            if (i + 1 < path.size()) {
+                const std::span<const Index> interior = chain(path[i], path[i + 1]);
+                out.insert(out.end(), interior.begin(), interior.end());
+            }
+        }
+        return out;
+    }
+
+    /* contracted index of original nodes without one */
+    static constexpr Index removed = std::numeric_limits<Index>::max();
+
+private:
+    /// @return position of the edge from from to to in graph().neighbors(), which must exist
+    constexpr uint64_t edge_of(const uint64_t from, const uint64_t to) const noexcept {
+        const EdgesType es = graph_.edges(from);
+        const auto it = std::find(es.begin(), es.end(), Index(to));
+        assert(it != es.end() && "no edge between from and to");
+        return graph_.offsets()[from] + (it - es.begin());
+    }
+
+    CsrGraph<D, Index> graph_;
+    std::vector<Length> lengths_;        /* per edge */
+    std::vector<Index> original_;        /* contracted -> original node */
+    std::vector<Index> contracted_;      /* original -> contracted node, removed if none */
+    std::vector<uint64_t> chain_offsets_; /* interior nodes of edge e: chain_nodes_[chain_offsets_[e] .. e + 1) */
+    std::vector<Index> chain_nodes_;
+};
+
+/// @brief Contract an undirected graph for queries between terminals:
+///        repeatedly remove non-terminal nodes with at most one edge, which removes whole dead-end branches,
+///        then replace every chain of non-terminal degree-2 nodes by one edge between the nodes at its ends.
+///        No simple path between two terminals goes into a dead-end branch, so shortest paths, and all
+///        simple paths, between terminals keep their lengths, apart from:
+///        of parallel edges (two chains between the same nodes) only the shortest is kept, and chains
+///        that return to their start, and components without junctions or terminals, are removed.
+///        For a maze graph, this removes all dead ends and corners, leaving the junctions of 3 or 4 corridors.
+/// \tparam Length Return type of get_edge_length
+/// @param graph undirected: every edge also exists in the opposite direction
+/// @param terminals nodes that are kept whatever their degree, e.g. entry and exit
+/// @param get_edge_length length of the edge between two adjacent nodes
+template <typename Length = long, Graph G,
+    CallableWithSignature<Length(uint64_t, uint64_t)> EdgeLength>
+auto contract(const G& graph, const std::span<const uint64_t> terminals, EdgeLength&& get_edge_length)
+{
+    using Index = typename G::IndexType;
+    using D = std::decay_t<decltype(graph.node(0))>;
+    using Result = ContractedGraph<D, Index, Length>;
+
+    const uint64_t n = graph.size();
+    std::vector<bool> terminal(n), removed(n);
+    for (const uint64_t t : terminals)
+        terminal[t] = true;
+
+    /* peel dead ends: removing one may turn its neighbour into the next dead end */
+    std::vector<uint32_t> degree(n);
+    std::vector<Index> dead_ends;
+    for (uint64_t i = 0; i < n; i++) {
+        degree[i] = graph.edges(i).size();
+        if (degree[i] <= 1 && !terminal[i])
+            dead_ends.push_back(i);
+    }
+    while (!dead_ends.empty()) {
+        const Index node = dead_ends.back();
+        dead_ends.pop_back();
+        removed[node] = true;
+        for (const Index e : graph.edges(node))
+            if (!removed[e] && --degree[e] == 1 && !terminal[e])
+                dead_ends.push_back(e);
+    }
+
+    /* the nodes at the ends of chains */
+    std::vector<Index> contracted(n, Result::removed);
+    std::vector<Index> original;
+    std::vector<D> data;
+    for (uint64_t i = 0; i < n; i++) {
+        if (removed[i] || (degree[i] == 2 && !terminal[i])) continue;
+        contracted[i] = original.size();
+        original.push_back(i);
+        data.push_back(graph.node(i));
+    }
+
+    std::vector<uint64_t> offsets { 0 };
+    std::vector<Index> neighbors;
+    std::vector<Length> lengths;
+    std::vector<uint64_t> chain_offsets { 0 };
+    std::vector<Index> chain_nodes;
+    offsets.reserve(original.size() + 1);
+
+    /* chains of the current start node, before removing parallel edges */
+    struct Walk {
+        Index to;
+        Length len;
+        uint64_t begin, end; /* interior nodes in walk_nodes */
+    };
+    std::vector<Walk> walks;
+    std::vector<Index> walk_nodes;
+
+    for (const Index start : original) {
+        walks.clear();
+        walk_nodes.clear();
+        for (const Index e : graph.edges(start)) {
+            if (removed[e]) continue;
+
+            /* follow the chain to the next kept node */
+            const uint64_t begin = walk_nodes.size();
+            Length len = get_edge_length(start, e);
+            Index prev = start, cur = e;
+            while (contracted[cur] == Result::removed) {
+                walk_nodes.push_back(cur);
+                const EdgeView auto& es = graph.edges(cur);
+                const auto next = std::find_if(es.begin(), es.end(),
+                    [&](const Index x) { return !removed[x] && x != prev; });
+                assert(next != es.end() && "chain node with a single neighbour");
+                len += get_edge_length(cur, *next);
+                prev = cur;
+                cur = *next;
+            }
+
+            /* chain back to start: never on a simple path */
+            if (cur == start) continue;
+            walks.push_back({ contracted[cur], len, begin, walk_nodes.size() });
+        }
+
+        for (uint64_t i = 0; i < walks.size(); i++) {
+            const Walk& w = walks[i];
+            /* parallel edges: keep the shortest, the first of equal ones */
+            bool shadowed = false;
+            for (uint64_t j = 0; j < walks.size(); j++)
+                shadowed |= walks[j].to == w.to && (walks[j].len < w.len || (j < i && !(w.len < walks[j].len)));
+            if (shadowed) continue;
+
+            neighbors.push_back(w.to);
+            lengths.push_back(w.len);
+            chain_nodes.insert(chain_nodes.end(), walk_nodes.begin() + w.begin, walk_nodes.begin() + w.end);
+            chain_offsets.push_back(chain_nodes.size());
+        }
+        offsets.push_back(neighbors.size());
+    }
+
+    return Result(
+        CsrGraph<D, Index>(std::move(data), std::move(offsets), std::move(neighbors)),
+        std::move(lengths), std::move(original), std::move(contracted),
+        std::move(chain_offsets), std::move(chain_nodes));
+}
+
+} // namespace mazes
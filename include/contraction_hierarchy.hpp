@@ -0,0 +1,405 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <array>
+#include <limits>
+#include <optional>
+#include <algorithm>
+#include <functional>
+#include <cassert>
+#include <concepts>
+
+#include <graph.hpp>
+#include <weighted_graph.hpp>
+#include <callable.hpp>
+#include <indexed_heap.hpp>
+
+namespace mazes {
+
+/// Contraction hierarchy of an undirected graph with non-negative edge lengths: an index built once,
+/// after which a shortest path query only searches upward from both ends and settles a few hundred nodes.
+/// Nodes are contracted one by one, cheapest first (fewest shortcuts added minus edges removed, plus
+/// contracted neighbours to spread the order evenly), re-checked when a node is popped. Contracting v adds a shortcut u-w for every pair of
+/// its neighbours whose shortest path goes through v, which a bounded witness search checks.
+/// Each node keeps its arcs to higher ranked nodes (edges and shortcuts), a shortcut remembers the node
+/// it bypasses, so a path of shortcuts unpacks into original nodes.
+/// \tparam Index Type of node indices
+/// \tparam Length Type of edge lengths
+template <std::unsigned_integral Index, typename Length>
+class ContractionHierarchy {
+public:
+    using Path = std::vector<Index>;
+
+    /// Arc to a higher ranked node: an original edge, or a shortcut over middle
+    struct Arc {
+        Index to;
+        Index middle; /* node bypassed by a shortcut, none for an original edge */
+        Length len;
+    };
+
+    static constexpr Index none = std::numeric_limits<Index>::max();
+
+    /// Buffers of a query, reused by the next query -> no allocations when it is warm.
+    /// One per thread: queries on one hierarchy run concurrently with their own workspaces
+    class Workspace {
+    public:
+        /// @return number of nodes settled by the last query, both directions
+        uint64_t settled() const noexcept { return settled_; }
+
+        /// @return length of the path found by the last query
+        Length length() const noexcept { return length_; }
+
+    private:
+        friend class ContractionHierarchy;
+
+        void begin(const uint64_t n) {
+            for (uint64_t side = 0; side < 2; side++) {
+                if (dist_[side].size() < n) {
+                    dist_[side].resize(n);
+                    parent_[side].resize(n, none);
+                }
+                for (const Index node : touched_[side])
+                    parent_[side][node] = none;
+                touched_[side].clear();
+                heap_[side].reset(n);
+            }
+            path_.clear();
+            stack_.clear();
+            settled_ = 0;
+        }
+
+        /* per direction: tentative distance, and the node it was reached from (none: not reached) */
+        std::array<std::vector<Length>, 2> dist_;
+        std::array<std::vector<Index>, 2> parent_;
+        std::array<std::vector<Index>, 2> touched_;
+        std::array<IndexedHeap<Length, std::less<>, 4, Index>, 2> heap_;
+        std::vector<Index> path_;
+        std::vector<Index> chain_; /* hierarchy nodes of the path, before unpacking */
+        std::vector<std::pair<Index, Index>> stack_; /* unpacking: arcs left to expand */
+        uint64_t settled_ = 0;
+        Length length_ {};
+    };
+
+    /// @brief Build the hierarchy
+    /// @param graph undirected: every edge also exists in the opposite direction, with the same length
+    /// @param get_edge_length non-negative length of the edge between two adjacent nodes
+    template <Graph G, CallableWithSignature<Length(uint64_t, uint64_t)> EdgeLength>
+    ContractionHierarchy(const G& graph, EdgeLength&& get_edge_length)
+    {
+        build(graph, get_edge_length);
+    }
+
+    /// @brief Build the hierarchy of a graph with stored edge lengths
+    template <WeightedGraph G>
+        requires std::same_as<typename G::LengthType, Length>
+    explicit ContractionHierarchy(const G& graph)
+    {
+        build(graph, StoredLengths<G>{ graph });
+    }
+
+    /// @return number of nodes
+    uint64_t size() const noexcept { return rank_.size(); }
+
+    /// @return position of node in the contraction order, higher ranks were contracted later
+    Index rank(const uint64_t node) const noexcept { return rank_[node]; }
+
+    /// @return number of shortcut arcs
+    uint64_t shortcuts() const noexcept { return nshortcuts_; }
+
+    /// @return arcs from node to higher ranked nodes
+    std::span<const Arc> up(const uint64_t node) const noexcept {
+        return { arcs_.data() + offsets_[node], arcs_.data() + offsets_[node + 1] };
+    }
+
+    /// Shortest path between from and to, in the buffers of workspace
+    /// \return Shortest path in original nodes, ordered from to to from like Dijkstra::search,
+    ///         or std::nullopt, if no path is found. The path lives in workspace until its next search
+    std::optional<std::span<const Index>> search(const uint64_t from, const uint64_t to, Workspace& ws) const
+    {
+        constexpr uint64_t fwd = 0, bwd = 1;
+        ws.begin(size());
+        reach(ws, fwd, Index(from), Length(), Index(from));
+        reach(ws, bwd, Index(to), Length(), Index(to));
+
+        Index meet = none;
+        Length best {};
+        while (true) {
+            /* a direction stops when its queue top is no shorter than the best path */
+            std::array<bool, 2> active;
+            for (uint64_t side = 0; side < 2; side++)
+                active[side] = !ws.heap_[side].empty()
+                    && (meet == none || ws.heap_[side].top().key < best);
+            if (!active[fwd] && !active[bwd]) break;
+
+            const uint64_t side = !active[bwd] || (active[fwd]
+                && !(ws.heap_[bwd].top().key < ws.heap_[fwd].top().key)) ? fwd : bwd;
+            const auto [node, d] = ws.heap_[side].pop();
+            ws.settled_++;
+
+            if (ws.parent_[1 - side][node] != none) {
+                const Length through = d + ws.dist_[1 - side][node];
+                if (meet == none || through < best) {
+                    meet = node;
+                    best = through;
+                }
+            }
+
+            if (stalled(ws, side, node, d)) continue;
+
+            for (const Arc& arc : up(node)) {
+                const Length nd = d + arc.len;
+                if (ws.parent_[side][arc.to] == none || nd < ws.dist_[side][arc.to])
+                    reach(ws, side, arc.to, nd, node);
+            }
+        }
+
+        if (meet == none) return std::nullopt;
+        ws.length_ = best;
+
+        /* parents lead back to the root of their direction: meet ... to, and meet ... from.
+           The path is to ... meet ... from, with each arc between hierarchy nodes unpacked */
+        std::vector<Index>& chain = ws.chain_;
+        chain.clear();
+        for (Index n = meet; n != Index(to); n = ws.parent_[bwd][n])
+            chain.push_back(n);
+        chain.push_back(Index(to));
+        ws.path_.push_back(Index(to));
+        for (uint64_t i = chain.size() - 1; i > 0; i--)
+            unpack(ws, chain[i], chain[i - 1]);
+        for (Index n = meet; n != Index(from); n = ws.parent_[fwd][n])
+            unpack(ws, n, ws.parent_[fwd][n]);
+        return std::span<const Index>(ws.path_);
+    }
+
+    /// Shortest path between from and to
+    /// \return Shortest path in original nodes, ordered from to to from like Dijkstra::search,
+    ///         or std::nullopt, if no path is found
+    std::optional<Path> search(const uint64_t from, const uint64_t to) const
+    {
+        Workspace ws;
+        const std::optional<std::span<const Index>> path = search(from, to, ws);
+        if (!path) return std::nullopt;
+        return Path(path->begin(), path->end());
+    }
+
+private:
+    /// Arc of the graph during contraction, between uncontracted nodes
+    struct BuildArc {
+        Index to;
+        Index middle;
+        Length len;
+    };
+
+    template <Graph G, typename EdgeLength>
+    void build(const G& graph, EdgeLength&& get_edge_length)
+    {
+        const uint64_t n = graph.size();
+        std::vector<std::vector<BuildArc>> adj(n);
+        for (uint64_t v = 0; v < n; v++) {
+            const EdgeView auto& edges = graph.edges(v);
+            for (uint64_t i = 0; i < edges.size(); i++) {
+                const Index e = edges[i];
+                if (e == v) continue;
+                add_arc(adj[v], { e, none, Length(edge_length(graph, get_edge_length, v, i, e)) });
+            }
+        }
+
+        Witness witness(n);
+        std::vector<uint32_t> deleted(n, 0); /* contracted neighbours */
+        std::vector<std::pair<Index, BuildArc>> shortcuts;
+
+        /* simulate: shortcuts of v, priority = shortcuts - removed arcs + contracted neighbours */
+        const auto priority = [&](const Index v) -> int64_t {
+            find_shortcuts(adj, v, witness, shortcuts);
+            return int64_t(shortcuts.size()) - int64_t(adj[v].size()) + int64_t(deleted[v]);
+        };
+
+        IndexedHeap<int64_t, std::less<>, 4, Index> order(n);
+        for (uint64_t v = 0; v < n; v++)
+            order.push(v, priority(v));
+
+        rank_.assign(n, 0);
+        std::vector<std::vector<BuildArc>> upward(n);
+        Index next_rank = 0;
+        while (!order.empty()) {
+            /* lazy update: the priority may have changed since it was pushed */
+            const Index v = order.pop().node;
+            const int64_t p = priority(v);
+            if (!order.empty() && p > order.top().key) {
+                order.push(v, p);
+                continue;
+            }
+
+            /* contract v: shortcuts were found by the last priority(v) */
+            rank_[v] = next_rank++;
+            for (const auto& [u, arc] : shortcuts)
+                nshortcuts_ += add_arc(adj[u], arc); /* shortening an existing arc adds no shortcut */
+            for (const BuildArc& arc : adj[v]) {
+                std::vector<BuildArc>& nb = adj[arc.to];
+                nb.erase(std::find_if(nb.begin(), nb.end(), [v](const BuildArc& a) { return a.to == v; }));
+                deleted[arc.to]++;
+            }
+            upward[v] = std::move(adj[v]);
+            adj[v] = {};
+        }
+
+        /* both directions of a shortcut were counted */
+        nshortcuts_ /= 2;
+
+        offsets_.assign(1, 0);
+        offsets_.reserve(n + 1);
+        for (uint64_t v = 0; v < n; v++) {
+            for (const BuildArc& arc : upward[v])
+                arcs_.push_back({ arc.to, arc.middle, arc.len });
+            offsets_.push_back(arcs_.size());
+        }
+    }
+
+    /// @brief Add arc, or shorten the existing arc to the same node
+    /// @return whether arc was added as a new arc
+    static bool add_arc(std::vector<BuildArc>& arcs, const BuildArc& arc)
+    {
+        const auto it = std::find_if(arcs.begin(), arcs.end(), [&](const BuildArc& a) { return a.to == arc.to; });
+        if (it == arcs.end()) {
+            arcs.push_back(arc);
+            return true;
+        }
+        if (arc.len < it->len)
+            *it = arc;
+        return false;
+    }
+
+    /// Bounded Dijkstra among uncontracted nodes, to find paths that make a shortcut unnecessary
+    struct Witness {
+        static constexpr uint64_t max_settled = 64;
+
+        explicit Witness(const uint64_t n)
+            : dist(n), reached(n, false), heap(n) { }
+
+        std::vector<Length> dist;
+        std::vector<bool> reached;
+        std::vector<Index> touched;
+        IndexedHeap<Length, std::less<>, 4, Index> heap;
+    };
+
+    /// @brief Shortcuts needed when v is contracted: for each pair of neighbours u, w of v, u-w
+    ///        unless the witness search finds a path from u to w avoiding v that is no longer
+    /// @param shortcuts receives (u, arc to w) and (w, arc to u) for each shortcut
+    static void find_shortcuts(const std::vector<std::vector<BuildArc>>& adj, const Index v,
+                               Witness& witness, std::vector<std::pair<Index, BuildArc>>& shortcuts)
+    {
+        shortcuts.clear();
+        const std::vector<BuildArc>& arcs = adj[v];
+        for (uint64_t i = 0; i < arcs.size(); i++) {
+            const BuildArc& in = arcs[i];
+            /* longest path through v from in.to that a witness has to beat */
+            Length limit {};
+            bool any = false;
+            for (uint64_t j = i + 1; j < arcs.size(); j++) {
+                const Length through = in.len + arcs[j].len;
+                if (!any || limit < through) limit = through;
+                any = true;
+            }
+            if (!any) continue;
+
+            witness_search(adj, in.to, v, limit, witness);
+            for (uint64_t j = i + 1; j < arcs.size(); j++) {
+                const BuildArc& out = arcs[j];
+                const Length through = in.len + out.len;
+                if (witness.reached[out.to] && !(through < witness.dist[out.to])) continue;
+                shortcuts.push_back({ in.to, { out.to, v, through } });
+                shortcuts.push_back({ out.to, { in.to, v, through } });
+            }
+        }
+    }
+
+    static void witness_search(const std::vector<std::vector<BuildArc>>& adj, const Index source,
+                               const Index avoid, const Length limit, Witness& w)
+    {
+        for (const Index t : w.touched)
+            w.reached[t] = false;
+        w.touched.clear();
+        w.heap.clear();
+
+        w.dist[source] = Length();
+        w.reached[source] = true;
+        w.touched.push_back(source);
+        w.heap.push(source, Length());
+
+        uint64_t settled = 0;
+        while (!w.heap.empty() && settled++ < Witness::max_settled) {
+            const auto [node, d] = w.heap.pop();
+            if (limit < d) break;
+            for (const BuildArc& arc : adj[node]) {
+                if (arc.to == avoid) continue;
+                const Length nd = d + arc.len;
+                if (w.reached[arc.to] && !(nd < w.dist[arc.to])) continue;
+                if (!w.reached[arc.to]) {
+                    w.reached[arc.to] = true;
+                    w.touched.push_back(arc.to);
+                }
+                w.dist[arc.to] = nd;
+                w.heap.push_or_decrease(arc.to, nd);
+            }
+        }
+    }
+
+    static void reach(Workspace& ws, const uint64_t side, const Index node, const Length d, const Index parent)
+    {
+        if (ws.parent_[side][node] == none)
+            ws.touched_[side].push_back(node);
+        ws.dist_[side][node] = d;
+        ws.parent_[side][node] = parent;
+        ws.heap_[side].push_or_decrease(node, d);
+    }
+
+    /// @return whether node, settled at d, is reached shorter from a higher node: then no shortest
+    ///         path continues upward from it (stall-on-demand)
+    bool stalled(const Workspace& ws, const uint64_t side, const Index node, const Length d) const
+    {
+        for (const Arc& arc : up(node)) {
+            if (ws.parent_[side][arc.to] == none) continue;
+            if (ws.dist_[side][arc.to] + arc.len < d) return true;
+        }
+        return false;
+    }
+
+    /// @return arc between a and b, stored at the lower ranked of the two
+    const Arc& arc_between(const Index a, const Index b) const
+    {
+        const bool a_lower = rank_[a] < rank_[b];
+        const Index low = a_lower ? a : b, high = a_lower ? b : a;
+        const std::span<const Arc> arcs = up(low);
+        const auto it = std::find_if(arcs.begin(), arcs.end(), [high](const Arc& arc) { return arc.to == high; });
+        assert(it != arcs.end() && "no arc between a and b");
+        return *it;
+    }
+
+    /// @brief Append the original nodes after a up to b, of the arc between a and b, to the path
+    void unpack(Workspace& ws, const Index a, const Index b) const
+    {
+        /* depth first over the shortcuts, left half first */
+        ws.stack_.clear();
+        ws.stack_.push_back({ a, b });
+        while (!ws.stack_.empty()) {
+            const auto [x, y] = ws.stack_.back();
+            ws.stack_.pop_back();
+            const Index middle = arc_between(x, y).middle;
+            if (middle == none) {
+                ws.path_.push_back(y);
+                continue;
+            }
+            ws.stack_.push_back({ middle, y });
+            ws.stack_.push_back({ x, middle });
+        }
+    }
+
+    std::vector<Index> rank_;
+    std::vector<uint64_t> offsets_;
+    std::vector<Arc> arcs_;
+    uint64_t nshortcuts_ = 0;
+};
+
+} // namespace mazes
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <cassert>
+#include <concepts>
+#include <memory>
+#include <utility>
+
+#include <edges.hpp>
+
+namespace mazes {
+
+/// Immutable directed graph in compressed sparse row form:
+/// the outgoing edges of node i are neighbors[offsets[i] .. offsets[i + 1]).
+/// Has the read interface of DirectedGraph (node, edges, size), so the search algorithms run on it unchanged.
+/// The arrays are either owned, or a view of external storage (e.g. a mapped file) kept alive by an owner.
+/// Copies share the arrays, which is safe because they are never changed.
+/// \tparam D Datatype stored in each node
+/// \tparam Index Type of node indices in edges and paths
+template<typename D, std::unsigned_integral Index = uint64_t>
+class CsrGraph {
+public:
+    using IndexType = Index;
+    using EdgesType = std::span<const Index>;
+    using Path = std::vector<Index>;
+
+    CsrGraph()
+            : CsrGraph({}, { 0 }, {}) {};
+
+    /// @param data data of each node
+    /// @param offsets size() + 1 ascending indices into neighbors, first is 0, last is neighbors.size()
+    /// @param neighbors edges of all nodes, concatenated
+    CsrGraph(
+            std::vector<D> data,
+            std::vector<uint64_t> offsets,
+            std::vector<Index> neighbors)
+    {
+        auto storage = std::make_shared<Storage>(Storage { std::move(data), std::move(offsets), std::move(neighbors) });
+        data_ = storage->data;
+        offsets_ = storage->offsets;
+        neighbors_ = storage->neighbors;
+        owner_ = std::move(storage);
+        assert(offsets_.size() == data_.size() + 1);
+        assert(offsets_.front() == 0 && offsets_.back() == neighbors_.size());
+    };
+
+    /// @brief View of external arrays, no copy. Same layout as the owning constructor
+    /// @param owner keeps the arrays alive as long as the graph or a copy of it lives
+    CsrGraph(
+            std::span<const D> data,
+            std::span<const uint64_t> offsets,
+            std::span<const Index> neighbors,
+            std::shared_ptr<const void> owner) noexcept
+            : data_{data}, offsets_{offsets}, neighbors_{neighbors}, owner_{std::move(owner)}
+    {
+        assert(offsets_.size() == data_.size() + 1);
+        assert(offsets_.front() == 0 && offsets_.back() == neighbors_.size());
+    };
+
+    /// @return data of node at given index
+    constexpr const D &node(const Index node_index) const noexcept {
+        return data_[node_index];
+    }
+
+    /// @param node_index index of node
+    /// @return list of outgoing edges from node at node_index
+    constexpr EdgesType edges(const Index node_index) const noexcept {
+        return { neighbors_.data() + offsets_[node_index],
+                 neighbors_.data() + offsets_[node_index + 1] };
+    }
+
+    /// @return list of nodes in graph
+    constexpr std::span<const D>
+    nodes() const noexcept { return data_; };
+
+    /// @return start of the edges of each node in neighbors(), followed by neighbors().size()
+    constexpr std::span<const uint64_t>
+    offsets() const noexcept { return offsets_; };
+
+    /// @return edges of all nodes, concatenated
+    constexpr std::span<const Index>
+    neighbors() const noexcept { return neighbors_; };
+
+    /// @return current number of nodes in graph
+    constexpr uint64_t size() const noexcept {
+        return data_.size();
+    }
+
+private:
+    /// Arrays of a graph that owns them
+    struct Storage {
+        std::vector<D> data;
+        std::vector<uint64_t> offsets;
+        std::vector<Index> neighbors;
+    };
+
+    std::span<const D> data_;
+    std::span<const uint64_t> offsets_;
+    std::span<const Index> neighbors_;
+    std::shared_ptr<const void> owner_; /* Storage, or owner of external arrays */
+};
+
+} // namespace mazes
@@ -7,8 +7,12 @@
 #include <memory>
 #include <algorithm>
 #include <iostream>
+#include <limits>
+#include <concepts>
 
 #include <edges.hpp>
+#include <csrgraph.hpp>
+#include <weighted_graph.hpp>
 
 namespace mazes {
 
@@ -20,47 +24,50 @@ constexpr uint64_t unlimited = UINT64_MAX;
 /// Directed graph using adjacency list -> not acyclic!
 /// \tparam D Datatype to store in each node
 /// \tparam MaxEdgesPerNode
-template<typename D, uint64_t MaxEdgesPerNode = unlimited>
+/// \tparam Index Type of node indices in edges and paths. Limits the graph to less than its max nodes
+template<typename D, uint64_t MaxEdgesPerNode = unlimited, std::unsigned_integral Index = uint64_t>
 class DirectedGraph {
 public:
-    using EdgesType = GetEdgesType<MaxEdgesPerNode>;
+    using IndexType = Index;
+    using EdgesType = GetEdgesType<MaxEdgesPerNode, Index>;
     using AdjList = AdjacencyList<EdgesType>;
 
-    using Path = std::vector<uint64_t>;
+    using Path = std::vector<Index>;
 
     constexpr DirectedGraph()
             : data_{}, adj_list_{} {};
 
     constexpr DirectedGraph(
             std::initializer_list<D> data,
-            std::initializer_list<uint64_t> adj_list = {})
+            std::initializer_list<Index> adj_list = {})
             : data_(data), adj_list_(adj_list) {};
 
     /// @return data of node at given index
-    constexpr D &node(const uint64_t node_index) noexcept {
+    constexpr D &node(const Index node_index) noexcept {
         return data_.at(node_index);
     }
 
     /// @return data of node at given index
-    constexpr const D &node(const uint64_t node_index) const noexcept {
+    constexpr const D &node(const Index node_index) const noexcept {
         return data_.at(node_index);
     }
 
     /// @param node_index index of node
     /// @return list of outgoing edges from node at node_index
-    constexpr EdgesType &edges(const uint64_t node_index) noexcept {
+    constexpr EdgesType &edges(const Index node_index) noexcept {
         return adj_list_.at(node_index);
     }
 
     /// @param node_index index of node
     /// @return list of outgoing edges from node at node_index
-    constexpr const EdgesType &edges(const uint64_t node_index) const noexcept {
+    constexpr const EdgesType &edges(const Index node_index) const noexcept {
         return adj_list_.at(node_index);
     }
 
     /// @param node data at node
     /// @return index of added node
-    constexpr uint64_t add_node(const D &node) {
+    constexpr Index add_node(const D &node) {
+        assert(data_.size() < std::numeric_limits<Index>::max() && "Index type too small for graph");
         data_.push_back(node);
         adj_list_.resize(adj_list_.size() + 1);
         return data_.size() - 1;
@@ -68,30 +75,31 @@ public:
 
     /// @param node data at node
     /// @return index of added node
-    constexpr uint64_t add_node(D &&node) {
+    constexpr Index add_node(D &&node) {
+        assert(data_.size() < std::numeric_limits<Index>::max() && "Index type too small for graph");
         data_.push_back(node);
         adj_list_.resize(adj_list_.size() + 1);
         return data_.size() - 1;
     }
 
     /// @brief create a directed edge
-    constexpr void add_edge(const uint64_t from, const uint64_t to) noexcept {
+    constexpr void add_edge(const Index from, const Index to) noexcept {
         edges(from).add_adjacency(to);
     }
 
     /// @brief remove a directed edge
-    constexpr void remove_edge(const uint64_t from, const uint64_t to) noexcept {
+    constexpr void remove_edge(const Index from, const Index to) noexcept {
         edges(from).remove_adjacency(to);
     }
 
     /// @brief create two directed edges between node1 and node2
-    constexpr void connect(const uint64_t node1, const uint64_t node2) noexcept {
+    constexpr void connect(const Index node1, const Index node2) noexcept {
         add_edge(node1, node2);
         add_edge(node2, node1);
     }
 
     /// @brief remove two directed edges between node1 and node2
-    constexpr void disconnect(const uint64_t node1, const uint64_t node2) noexcept {
+    constexpr void disconnect(const Index node1, const Index node2) noexcept {
         remove_edge(node1, node2);
         remove_edge(node2, node1);
     }
@@ -124,6 +132,30 @@ public:
         return adj_list_.size();
     }
 
+    /// @return immutable compressed sparse row copy of the graph, for read-only solving
+    CsrGraph<D, Index> freeze() const {
+        std::vector<uint64_t> offsets;
+        offsets.reserve(size() + 1);
+        offsets.push_back(0);
+        for (const EdgesType& edges : adj_list_)
+            offsets.push_back(offsets.back() + edges.size());
+
+        std::vector<Index> neighbors;
+        neighbors.reserve(offsets.back());
+        for (const EdgesType& edges : adj_list_)
+            neighbors.insert(neighbors.end(), edges.begin(), edges.end());
+
+        return CsrGraph<D, Index>(data_, std::move(offsets), std::move(neighbors));
+    }
+
+    /// @return immutable compressed sparse row copy of the graph with the length of every edge stored,
+    ///         for searching without an edge length callback
+    /// @param get_edge_length length of the edge between two adjacent nodes, called once per edge
+    template<typename Length, typename EdgeLength>
+    WeightedCsrGraph<D, Index, Length> freeze(EdgeLength&& get_edge_length) const {
+        return WeightedCsrGraph<D, Index, Length>(freeze(), get_edge_length);
+    }
+
 private:
     std::vector<D> data_;
     AdjList adj_list_;
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <span>
+#include <limits>
+#include <optional>
+#include <filesystem>
+#include <functional>
+
+#include <maze.hpp>
+#include <bitmaze.hpp>
+#include <mazegraph.hpp>
+#include <indexed_heap.hpp>
+
+namespace mazes {
+
+/// Shortest distance to one target, and the next step towards it, for every node of a maze graph
+/// or every cell of a maze, computed by one Dijkstra (nodes) or BFS (cells) from the target.
+/// Then the route from any start is a pointer chase along next(), without a search, so any number of
+/// agents heading to the same exit share one field. 8 bytes per element.
+/// Rebuilding reuses the arrays and the queue of the last build -> no allocations for a maze of the same size.
+class DistanceField {
+public:
+    using Index = MazeGraph::IndexType;
+
+    enum class Domain : uint32_t {
+        nodes, /* indices are nodes of a WeightedMazeGraph */
+        cells  /* indices are maze.index_of() of cells */
+    };
+
+    /* distance of elements the target is not reachable from */
+    static constexpr uint32_t unreachable = std::numeric_limits<uint32_t>::max();
+    /* next of the target and of unreachable elements */
+    static constexpr Index none = std::numeric_limits<Index>::max();
+
+    DistanceField() = default;
+
+    /// @brief Field over the nodes of graph, distances in cells along the corridors
+    /// @param target node all routes lead to, e.g. the exit graph.size() - 1
+    DistanceField(const WeightedMazeGraph& graph, uint64_t target);
+
+    /// @brief Field over the cells of maze, distances in cells
+    /// @param target path cell all routes lead to, e.g. the hole in the bottom row
+    DistanceField(const Maze& maze, Point target);
+    DistanceField(const BitMaze& maze, Point target);
+
+    /// @brief Recompute the field, e.g. after the maze changed, in the buffers of the last build
+    void rebuild(const WeightedMazeGraph& graph, uint64_t target);
+    void rebuild(const Maze& maze, Point target);
+    void rebuild(const BitMaze& maze, Point target);
+
+    Domain domain() const noexcept { return domain_; }
+
+    /// @return number of nodes or cells
+    uint64_t size() const noexcept { return distance_.size(); }
+
+    /// @return node or cell index of the target
+    Index target() const noexcept { return target_; }
+
+    /// @return length of the shortest path from element to the target, or unreachable
+    uint32_t distance(const uint64_t element) const noexcept { return distance_[element]; }
+
+    /// @return next node or cell on a shortest path from element to the target, none for the target itself
+    Index next(const uint64_t element) const noexcept { return next_[element]; }
+
+    bool reachable(const uint64_t element) const noexcept { return distance_[element] != unreachable; }
+
+    /// @return distances of all elements
+    std::span<const uint32_t> distances() const noexcept { return distance_; }
+
+    /// @return next step of all elements
+    std::span<const Index> next_hops() const noexcept { return next_; }
+
+    /// @brief Shortest path from from to the target in O(path length), by following next()
+    /// @param out receives the path, ordered from from to the target, empty if the target is not reachable
+    /// @return whether the target is reachable from from
+    bool path(uint64_t from, std::vector<Index>& out) const;
+
+    /// @return shortest path from from to the target, or std::nullopt, if it is not reachable
+    std::optional<std::vector<Index>> path(uint64_t from) const;
+
+private:
+    friend bool save_distance_field(const DistanceField&, uint64_t, const std::filesystem::path&);
+    friend std::optional<DistanceField> load_distance_field(const std::filesystem::path&, uint64_t);
+
+    template <typename MazeType>
+    void rebuild_cells(const MazeType& maze, Point target);
+
+    /// @return whether every next() is in range or none, the target is at distance 0 without next,
+    ///         and the distance strictly decreases along next(), so that path() ends at the target
+    bool valid() const noexcept;
+
+    /// @brief Start a build over n elements: all unreachable, target at distance 0
+    void begin(Domain domain, uint64_t n, uint64_t target);
+
+    Domain domain_ = Domain::nodes;
+    Index target_ = none;
+    std::vector<uint32_t> distance_;
+    std::vector<Index> next_;
+    /* queues of the builds, kept for the next rebuild */
+    std::vector<Index> frontier_;
+    IndexedHeap<uint32_t, std::less<>, 4, Index> heap_;
+};
+
+/// Distance field file: this header, followed by the arrays of a DistanceField:
+/// distances (uint32_t[size]) and next hops (Index[size]). All fields little endian.
+/// A file is only used for the maze with the same maze_hash, and with the same version and index size.
+struct DistanceFieldHeader {
+    static constexpr std::array<char, 8> magic_value = { 'M', 'A', 'Z', 'E', 'D', 'I', 'S', 'T' };
+    static constexpr uint32_t current_version = 1;
+
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t index_bytes; /* sizeof(DistanceField::Index) */
+    uint64_t maze_hash;   /* maze_hash() of the maze the field was built for */
+    uint64_t size;
+    uint32_t target;
+    uint32_t domain;      /* DistanceField::Domain */
+};
+static_assert(sizeof(DistanceFieldHeader) == 40 && sizeof(DistanceFieldHeader) % 8 == 0);
+
+/// @brief Write field, built for the maze with given hash, as distance field file
+/// @return false if the file could not be written
+bool save_distance_field(const DistanceField& field, uint64_t maze_hash, const std::filesystem::path& path);
+
+/// @brief Read a distance field file: two bulk reads into the arrays, no parsing
+/// @return nullopt if the file cannot be read, does not match maze_hash, the version or the index size,
+///         or its arrays are not a valid field (checked once, so that a corrupt file cannot break path())
+std::optional<DistanceField> load_distance_field(const std::filesystem::path& path, uint64_t maze_hash);
+
+} // namespace mazes
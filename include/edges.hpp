@@ -5,41 +5,54 @@
 #include <vector>
 #include <array>
 #include <algorithm>
+#include <limits>
+#include <concepts>
 
 namespace mazes {
 
 template<typename A>
-concept Edges =requires(A adj, uint64_t node, size_t index) {
+concept Edges =requires(A adj, typename A::IndexType node, size_t index) {
     { adj.add_adjacency(node) } -> std::same_as<void>;
     { adj.remove_adjacency(node) } -> std::same_as<void>;
     { adj.size() } -> std::same_as<std::size_t>;
-    { adj.at(index) } -> std::same_as<uint64_t &>;
-    { adj[index] } -> std::same_as<uint64_t &>;
+    { adj.at(index) } -> std::same_as<typename A::IndexType &>;
+    { adj[index] } -> std::same_as<typename A::IndexType &>;
+    { adj.begin() } -> std::random_access_iterator;
+    { adj.end() } -> std::random_access_iterator;
+    { *adj.begin() } -> std::same_as<typename A::IndexType &>;
+};
+
+/// Read-only list of outgoing edges, as used by the search algorithms
+template<typename A>
+concept EdgeView = requires(const A adj, size_t index) {
+    { adj.size() } -> std::convertible_to<std::size_t>;
+    { adj[index] } -> std::convertible_to<uint64_t>;
     { adj.begin() } -> std::random_access_iterator;
     { adj.end() } -> std::random_access_iterator;
-    { *adj.begin() } -> std::same_as<uint64_t &>;
 };
 
 /// @brief Adjacency-list with static size
 /// @tparam Size size of list
-template<uint64_t Size>
+/// @tparam Index type of node indices
+template<uint64_t Size, std::unsigned_integral Index = uint64_t>
 struct StaticEdges
-        : private std::array<uint64_t, Size> {
-    using container = std::array<uint64_t, Size>;
-    static constexpr uint64_t nullidx = UINT64_MAX;
-    uint64_t sz_;
+        : private std::array<Index, Size> {
+    using container = std::array<Index, Size>;
+    using IndexType = Index;
+    static constexpr Index nullidx = std::numeric_limits<Index>::max();
+    Index sz_;
 
     constexpr StaticEdges()
-            : std::array<uint64_t, Size>{},
+            : std::array<Index, Size>{},
               sz_{0} {
     }
 
-    constexpr void add_adjacency(uint64_t n) noexcept {
-        assert(size() < 4);
-        container::at(sz_++) = n; /* "push back" */
+    constexpr void add_adjacency(Index n) noexcept {
+        assert(size() < Size);
+        container::operator[](sz_++) = n; /* "push back" */
     }
 
-    constexpr void remove_adjacency(uint64_t n) noexcept {
+    constexpr void remove_adjacency(Index n) noexcept {
         const auto p = std::find(begin(), end(), n);
         assert(p != end() && "Edge not found");
 
@@ -60,19 +73,24 @@ struct StaticEdges
     using container::at;
     using container::operator[];
 
-    constexpr uint64_t size() const noexcept {
+    constexpr std::size_t size() const noexcept {
         return sz_;
     }
 };
 
-struct DynamicEdges : protected std::vector<uint64_t> {
-    using container = std::vector<uint64_t>;
+/// @brief Adjacency-list with dynamic size
+/// @tparam Index type of node indices
+template<std::unsigned_integral Index = uint64_t>
+struct DynamicEdges : protected std::vector<Index> {
+    using container = std::vector<Index>;
+    using IndexType = Index;
+    static constexpr Index nullidx = std::numeric_limits<Index>::max();
 
-    constexpr void add_adjacency(uint64_t n) noexcept {
+    constexpr void add_adjacency(Index n) noexcept {
         container::push_back(n);
     };
 
-    constexpr void remove_adjacency(uint64_t n) noexcept {
+    constexpr void remove_adjacency(Index n) noexcept {
         container::erase(
                 std::remove(container::begin(), container::end(), n),
                 container::end());
@@ -84,17 +102,17 @@ struct DynamicEdges : protected std::vector<uint64_t> {
     using container::begin, container::end;
 };
 
-template<uint64_t MaxAdjacencies>
+template<uint64_t MaxAdjacencies, std::unsigned_integral Index>
 consteval auto get_edges_type() noexcept {
     if constexpr (MaxAdjacencies <= 4) {
-        return StaticEdges<MaxAdjacencies>();
+        return StaticEdges<MaxAdjacencies, Index>();
     } else {
-        return DynamicEdges();
+        return DynamicEdges<Index>();
     }
 }
 
-template<uint64_t MaxEdgesPerNode>
+template<uint64_t MaxEdgesPerNode, std::unsigned_integral Index = uint64_t>
 using GetEdgesType
-        = decltype(get_edges_type<MaxEdgesPerNode>());
+        = decltype(get_edges_type<MaxEdgesPerNode, Index>());
 
 } // namespace mazes
\ No newline at end of file
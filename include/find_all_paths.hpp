@@ -2,15 +2,27 @@
 
 #pragma once
 
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <optional>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+
 #include <algorithms/depth_first.hpp>
+#include <path_set.hpp>
 
 namespace mazes {
-template<typename D, size_t N>
-constexpr std::vector<PathType<DirectedGraph<D, N>>> find_all_paths(
-    const DirectedGraph<D, N> &graph,
+template<Graph G>
+constexpr std::vector<PathType<G>> find_all_paths(
+    const G &graph,
     const uint64_t from, const uint64_t to)
 {
-    std::vector<PathType<DirectedGraph<D, N>>> paths;
+    std::vector<PathType<G>> paths;
     const auto on_find = [&paths](const auto & new_path) {
         paths.push_back(new_path);
     };
@@ -18,4 +30,199 @@ constexpr std::vector<PathType<DirectedGraph<D, N>>> find_all_paths(
     DepthFirst::search_and_continue(graph, from, to, on_find);
     return paths;
 }
-};
\ No newline at end of file
+
+/// Lazy range of all simple paths from from to to, in the order of find_all_paths.
+/// Each path is found when the iterator is incremented, and *it refers to the cursor's current path,
+/// which is overwritten by the next increment -> memory stays O(path length + graph size),
+/// however many paths there are. Single pass: begin() may only be called once.
+/// e.g. the number of paths shorter than 100 nodes, without storing any:
+///     std::ranges::count_if(all_paths(graph, from, to), [](const auto& p) { return p.size() < 100; })
+template <Graph G>
+class PathRange : public std::ranges::view_interface<PathRange<G>> {
+public:
+    class iterator {
+    public:
+        using value_type = PathType<G>;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(DepthFirstCursor<G>& cursor)
+            : cursor_{&cursor}, found_{cursor.next()} { }
+
+        const PathType<G>& operator*() const noexcept { return cursor_->path(); }
+        const PathType<G>* operator->() const noexcept { return &cursor_->path(); }
+
+        iterator& operator++() {
+            found_ = cursor_->next();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept { return !it.found_; }
+
+    private:
+        DepthFirstCursor<G>* cursor_ = nullptr;
+        bool found_ = false;
+    };
+
+    PathRange(const G& graph, const uint64_t from, const uint64_t to)
+        : cursor_{graph, from, to} { }
+
+    iterator begin() { return iterator(cursor_); }
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+    DepthFirstCursor<G> cursor_;
+};
+
+/// @brief find_all_paths as a lazy range: paths are enumerated while iterating, none is stored.
+///        Stop early by leaving the loop, or filter with std::views
+template <Graph G>
+PathRange<G> all_paths(const G& graph, const uint64_t from, const uint64_t to)
+{
+    return PathRange<G>(graph, from, to);
+}
+
+/// @brief find_all_paths into a PathSet: the paths share their common prefixes
+///        -> about an order of magnitude less memory than the vector of paths
+template <Graph G>
+PathSet<G> find_all_paths_set(const G& graph, const uint64_t from, const uint64_t to)
+{
+    PathSet<G> paths(graph, from);
+    for (const PathType<G>& path : all_paths(graph, from, to))
+        paths.add(path);
+    paths.shrink_to_fit();
+    return paths;
+}
+
+/// @brief Enumerate all simple paths from from to to on nthreads threads.
+///        A task is a path prefix, enumerated by the worker's own DepthFirstCursor (own on-path bitset).
+///        Workers take tasks from the back of their own deque and steal from the front of the others.
+///        While workers are idle, busy workers split their shallowest untried edge off into a new task,
+///        so the DFS tree is split at shallow depths, but only as far as needed to keep everyone busy.
+/// @param on_find called as on_find(worker, path) for every path, path ordered from from to to.
+///        Calls with different worker in [0, nthreads) happen concurrently, calls with the same worker never.
+///        The paths are found in no particular order
+/// @param nthreads number of worker threads, 0 for one per hardware thread
+template <Graph G, CallableWithSignature<void(uint64_t, const PathType<G>&)> OnFindFunc>
+void find_all_paths_parallel(
+    const G& graph,
+    const uint64_t from, const uint64_t to,
+    OnFindFunc&& on_find,
+    uint32_t nthreads = 0)
+{
+    using Task = PathType<G>;
+    constexpr uint64_t check_steps = 1024; /* edges tried between checks for idle workers */
+
+    if (nthreads == 0)
+        nthreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    /* own cache line per worker: the owner and thieves lock it at the same time */
+    struct alignas(64) TaskDeque {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    std::vector<TaskDeque> deques(nthreads);
+    deques[0].tasks.push_back({ typename G::IndexType(from) });
+
+    std::atomic<uint64_t> pending { 1 }; /* tasks queued or running, 0 -> all paths found */
+    std::atomic<uint64_t> queued { 1 };  /* tasks queued */
+    std::atomic<uint64_t> idle { 0 };    /* workers without a task */
+
+    const auto take = [&](const uint64_t w) -> std::optional<Task> {
+        for (uint64_t k = 0; k < nthreads; k++) {
+            const uint64_t victim = (w + k) % nthreads;
+            TaskDeque& deque = deques[victim];
+            const std::lock_guard lock(deque.mutex);
+            if (deque.tasks.empty()) continue;
+
+            /* own deque: newest, deepest task; stolen: oldest, shallowest task */
+            Task task;
+            if (victim == w) {
+                task = std::move(deque.tasks.back());
+                deque.tasks.pop_back();
+            } else {
+                task = std::move(deque.tasks.front());
+                deque.tasks.pop_front();
+            }
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return task;
+        }
+        return std::nullopt;
+    };
+
+    const auto worker = [&](const uint64_t w) {
+        DepthFirstCursor<G> cursor(graph, from, to);
+        Task split;
+        bool is_idle = false;
+        while (true) {
+            std::optional<Task> task = take(w);
+            if (!task) {
+                if (pending.load(std::memory_order_acquire) == 0) break;
+                if (!is_idle) idle.fetch_add(1, std::memory_order_relaxed);
+                is_idle = true;
+                std::this_thread::yield();
+                continue;
+            }
+            if (is_idle) idle.fetch_sub(1, std::memory_order_relaxed);
+            is_idle = false;
+
+            cursor.reset(*task);
+            while (true) {
+                const auto step = cursor.next(check_steps);
+                if (step == DepthFirstCursor<G>::Step::done) break;
+                if (step == DepthFirstCursor<G>::Step::found)
+                    on_find(w, cursor.path());
+
+                if (queued.load(std::memory_order_relaxed) < idle.load(std::memory_order_relaxed)
+                    && cursor.split(split)) {
+                    pending.fetch_add(1, std::memory_order_relaxed);
+                    const std::lock_guard lock(deques[w].mutex);
+                    deques[w].tasks.push_back(split);
+                    queued.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            pending.fetch_sub(1, std::memory_order_release);
+        }
+    };
+
+    if (nthreads == 1) {
+        worker(0);
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(nthreads);
+        for (uint64_t w = 0; w < nthreads; w++)
+            threads.emplace_back(worker, w);
+        for (std::thread& t : threads)
+            t.join();
+    }
+}
+
+/// @brief find_all_paths on nthreads threads, see find_all_paths_parallel above
+/// @return all simple paths from from to to, in no particular order
+template<Graph G>
+std::vector<PathType<G>> find_all_paths_parallel(
+    const G& graph,
+    const uint64_t from, const uint64_t to,
+    uint32_t nthreads = 0)
+{
+    if (nthreads == 0)
+        nthreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    /* one output per worker, no locking */
+    struct alignas(64) Output {
+        std::vector<PathType<G>> paths;
+    };
+    std::vector<Output> outputs(nthreads);
+    find_all_paths_parallel(graph, from, to,
+        [&outputs](const uint64_t worker, const PathType<G>& path) {
+            outputs[worker].paths.push_back(path);
+        }, nthreads);
+
+    std::vector<PathType<G>> paths = std::move(outputs[0].paths);
+    for (uint64_t w = 1; w < nthreads; w++)
+        paths.insert(paths.end(),
+            std::make_move_iterator(outputs[w].paths.begin()), std::make_move_iterator(outputs[w].paths.end()));
+    return paths;
+}
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <concepts>
+
+#include <edges.hpp>
+
+namespace mazes {
+
+/// Read interface of a graph, as used by the search algorithms:
+/// DirectedGraph and CsrGraph
+template<typename G>
+concept Graph = requires(const G graph, uint64_t node_index) {
+    typename G::Path;
+    typename G::IndexType;
+    { graph.size() } -> std::convertible_to<uint64_t>;
+    { graph.edges(node_index) } -> EdgeView;
+    graph.node(node_index);
+};
+
+} // namespace mazes
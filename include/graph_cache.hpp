@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <optional>
+#include <filesystem>
+
+#include <mazegraph.hpp>
+
+namespace mazes {
+
+/// Graph cache file: this header, followed by the arrays of a MazeCsrGraph:
+/// nodes (Point[nnodes]), offsets (uint64_t[nnodes + 1]) and neighbors (Index[nedges]).
+/// All fields little endian, every array starts 8 byte aligned, so a mapped file is used in place.
+/// A file is only used for the maze with the same maze_hash, and with the same version and index size.
+struct GraphCacheHeader {
+    static constexpr std::array<char, 8> magic_value = { 'M', 'A', 'Z', 'E', 'G', 'R', 'P', 'H' };
+    static constexpr uint32_t current_version = 1; /* increase when the format or graph_from_maze changes */
+
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t index_bytes; /* sizeof(MazeGraph::IndexType) */
+    uint64_t maze_hash;   /* maze_hash() of the maze the graph was built from */
+    uint64_t nnodes;
+    uint64_t nedges;
+};
+static_assert(sizeof(GraphCacheHeader) == 40 && sizeof(GraphCacheHeader) % 8 == 0);
+
+/// @brief Write graph, built from the maze with given hash, as graph cache file
+/// @return false if the file could not be written
+bool save_graph_cache(const MazeCsrGraph& graph, uint64_t maze_hash, const std::filesystem::path& path);
+
+/// @brief Map a graph cache file: the graph is a view of the mapped arrays, there is no parsing and no copy.
+///        Offsets and neighbors are checked once, so that a corrupt file cannot crash a search
+/// @return nullopt if the file does not exist, does not match maze_hash, the version or the index size,
+///         or its arrays are not a valid graph
+std::optional<MazeCsrGraph> load_graph_cache(const std::filesystem::path& path, uint64_t maze_hash);
+
+/// @return file of the graph for the maze with given hash in cache_dir
+std::filesystem::path graph_cache_path(const std::filesystem::path& cache_dir, uint64_t maze_hash);
+
+/// @brief graph_from_maze(maze).freeze(), loaded from cache_dir if it was built before, else built and stored
+/// @param maze_hash maze_hash(maze), e.g. from the header of a binary maze file
+MazeCsrGraph cached_graph_from_maze(const BitMaze& maze, uint64_t maze_hash, const std::filesystem::path& cache_dir);
+
+/// @brief graph_from_maze(maze).freeze(), loaded from cache_dir if it was built before, else built and stored
+MazeCsrGraph cached_graph_from_maze(const BitMaze& maze, const std::filesystem::path& cache_dir);
+
+} // namespace mazes
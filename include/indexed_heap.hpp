@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <functional>
+#include <cassert>
+#include <utility>
+#include <algorithm>
+#include <limits>
+#include <concepts>
+
+namespace mazes {
+
+/// Addressable d-ary min-heap over the node indices [0, capacity) of a graph.
+/// Every node is at most once in the heap, and its key can be lowered in place (decrease-key).
+/// \tparam Key priority of a node
+/// \tparam Compare strict weak ordering on Key, the smallest element is on top
+/// \tparam Arity number of children per heap element
+/// \tparam Index type of node indices, also used for positions in the heap
+template <typename Key, typename Compare = std::less<Key>, uint64_t Arity = 4, std::unsigned_integral Index = uint64_t>
+class IndexedHeap {
+    static_assert(Arity >= 2, "heap needs at least two children per element");
+
+public:
+    struct Element {
+        Index node;
+        Key key;
+    };
+
+    /* position of nodes that are not in the heap */
+    static constexpr Index npos = std::numeric_limits<Index>::max();
+
+    constexpr IndexedHeap() = default;
+
+    constexpr explicit IndexedHeap(const uint64_t capacity, Compare compare = Compare())
+        : heap_{}, positions_(capacity, npos), compare_{compare} { };
+
+    /// @brief Remove all elements and allow nodes in [0, capacity)
+    constexpr void reset(const uint64_t capacity) {
+        clear();
+        positions_.resize(capacity, npos);
+    }
+
+    /// @brief Remove all elements. Only touches the positions of the remaining elements.
+    constexpr void clear() noexcept {
+        for (const Element& elm : heap_)
+            positions_[elm.node] = npos;
+        heap_.clear();
+    }
+
+    constexpr bool empty() const noexcept { return heap_.empty(); }
+    constexpr uint64_t size() const noexcept { return heap_.size(); }
+    constexpr uint64_t capacity() const noexcept { return positions_.size(); }
+
+    /// @brief Allocate space for given amount of simultaneous elements
+    constexpr void reserve(const uint64_t n) { heap_.reserve(n); }
+
+    /// @return whether node is currently in the heap
+    constexpr bool contains(const Index node) const noexcept {
+        return positions_[node] != npos;
+    }
+
+    /// @return key of node, which must be in the heap
+    constexpr const Key& key(const Index node) const noexcept {
+        assert(contains(node));
+        return heap_[positions_[node]].key;
+    }
+
+    /// @return element with the smallest key
+    constexpr const Element& top() const noexcept {
+        assert(!empty());
+        return heap_.front();
+    }
+
+    /// @brief insert node, which must not be in the heap
+    constexpr void push(const Index node, const Key& key) {
+        assert(!contains(node));
+        heap_.push_back({ node, key });
+        positions_[node] = heap_.size() - 1;
+        sift_up(heap_.size() - 1);
+    }
+
+    /// @brief lower the key of node, which must be in the heap
+    constexpr void decrease(const Index node, const Key& key) noexcept {
+        assert(contains(node));
+        const Index pos = positions_[node];
+        assert(!compare_(heap_[pos].key, key) && "key can only decrease");
+        heap_[pos].key = key;
+        sift_up(pos);
+    }
+
+    /// @brief insert node, or lower its key if it is already in the heap
+    /// @return false if node was in the heap with a key not larger than key
+    constexpr bool push_or_decrease(const Index node, const Key& key) {
+        if (!contains(node)) {
+            push(node, key);
+            return true;
+        }
+
+        if (!compare_(key, heap_[positions_[node]].key))
+            return false;
+
+        decrease(node, key);
+        return true;
+    }
+
+    /// @brief remove the element with the smallest key
+    constexpr Element pop() noexcept {
+        assert(!empty());
+        const Element top = heap_.front();
+        positions_[top.node] = npos;
+
+        const Element last = heap_.back();
+        heap_.pop_back();
+        if (!heap_.empty()) {
+            heap_.front() = last;
+            positions_[last.node] = 0;
+            sift_down(0);
+        }
+
+        return top;
+    }
+
+private:
+    constexpr void sift_up(Index pos) noexcept {
+        const Element elm = heap_[pos];
+        while (pos > 0) {
+            const Index parent = (pos - 1) / Arity;
+            if (!compare_(elm.key, heap_[parent].key))
+                break;
+            heap_[pos] = heap_[parent];
+            positions_[heap_[pos].node] = pos;
+            pos = parent;
+        }
+        heap_[pos] = elm;
+        positions_[elm.node] = pos;
+    }
+
+    constexpr void sift_down(Index pos) noexcept {
+        const Element elm = heap_[pos];
+        const uint64_t sz = heap_.size();
+        while (true) {
+            const uint64_t first = pos * Arity + 1;
+            if (first >= sz) break;
+
+            /* find smallest child */
+            const uint64_t last = std::min(first + Arity, sz);
+            uint64_t best = first;
+            for (uint64_t c = first + 1; c < last; c++)
+                if (compare_(heap_[c].key, heap_[best].key))
+                    best = c;
+
+            if (!compare_(heap_[best].key, elm.key))
+                break;
+            heap_[pos] = heap_[best];
+            positions_[heap_[pos].node] = pos;
+            pos = best;
+        }
+        heap_[pos] = elm;
+        positions_[elm.node] = pos;
+    }
+
+    std::vector<Element> heap_;
+    std::vector<Index> positions_;
+    Compare compare_;
+};
+
+} // namespace mazes
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <cassert>
+#include <concepts>
+
+#include <graph.hpp>
+#include <weighted_graph.hpp>
+#include <callable.hpp>
+#include <indexed_heap.hpp>
+
+namespace mazes {
+
+/// Landmarks for the ALT heuristic of A* (A*, landmarks, triangle inequality): the exact distances from
+/// k landmark nodes to every node, computed once. For a landmark l, |d(l, to) - d(l, node)| never exceeds
+/// the distance from node to to, so the largest of these over all landmarks is a lower bound that follows
+/// the corridors of a maze, unlike a straight-line distance.
+/// Landmarks are chosen by farthest-point selection: each is the node farthest from the ones before,
+/// so they spread to the borders of the graph, where they bound the most paths.
+/// \tparam Index Type of node indices
+/// \tparam Length Type of edge lengths and distances
+template <std::unsigned_integral Index, typename Length>
+class Landmarks {
+public:
+    /* distance to nodes that a landmark does not reach */
+    static constexpr Length unreachable = std::numeric_limits<Length>::max();
+
+    /// Heuristic of A* towards one target: callable with a node, returns a lower bound of its distance to the target
+    class Heuristic {
+    public:
+        Heuristic(const Landmarks& landmarks, const uint64_t to)
+            : landmarks_{&landmarks}, target_{landmarks.distances(to)} { }
+
+        Length operator()(const uint64_t node) const noexcept {
+            const std::span<const Length> d = landmarks_->distances(node);
+            Length bound {};
+            for (uint64_t l = 0; l < d.size(); l++) {
+                /* a landmark that does not reach both nodes says nothing about their distance */
+                if (d[l] == unreachable || target_[l] == unreachable) continue;
+                const Length diff = d[l] < target_[l] ? target_[l] - d[l] : d[l] - target_[l];
+                bound = std::max(bound, diff);
+            }
+            return bound;
+        }
+
+    private:
+        const Landmarks* landmarks_;
+        std::span<const Length> target_;
+    };
+
+    /// @brief Choose count landmarks and compute their distances, one Dijkstra each
+    /// @param graph undirected: every edge also exists in the opposite direction, with the same length
+    /// @param count number of landmarks, at most graph.size(). More give tighter bounds,
+    ///        for count times the memory and a slower heuristic
+    /// @param get_edge_length non-negative length of the edge between two adjacent nodes
+    template <Graph G, CallableWithSignature<Length(uint64_t, uint64_t)> EdgeLength>
+    Landmarks(const G& graph, const uint64_t count, EdgeLength&& get_edge_length)
+    {
+        build(graph, count, get_edge_length);
+    }
+
+    /// @brief Landmarks of a graph with stored edge lengths
+    template <WeightedGraph G>
+        requires std::same_as<typename G::LengthType, Length>
+    Landmarks(const G& graph, const uint64_t count)
+    {
+        build(graph, count, StoredLengths<G>{ graph });
+    }
+
+    /// @return number of nodes
+    uint64_t size() const noexcept { return size_; }
+
+    /// @return the landmark nodes, in the order they were chosen
+    std::span<const Index> nodes() const noexcept { return landmarks_; }
+
+    /// @return distance from each landmark to node, unreachable if it does not reach it
+    std::span<const Length> distances(const uint64_t node) const noexcept {
+        const uint64_t k = landmarks_.size();
+        return { dist_.data() + node * k, dist_.data() + (node + 1) * k };
+    }
+
+    /// @return lower bound of the distance between from and to
+    Length lower_bound(const uint64_t from, const uint64_t to) const noexcept {
+        return Heuristic(*this, to)(from);
+    }
+
+    /// @return heuristic towards to for AStar::search, valid as long as the landmarks
+    Heuristic heuristic(const uint64_t to) const noexcept { return Heuristic(*this, to); }
+
+private:
+    template <Graph G, typename EdgeLength>
+    void build(const G& graph, const uint64_t count, EdgeLength&& get_edge_length)
+    {
+        size_ = graph.size();
+        assert(count <= size_);
+        landmarks_.reserve(count);
+        /* node-major: the heuristic reads all distances of a node at once */
+        dist_.assign(size_ * count, unreachable);
+
+        std::vector<Length> from_landmark(size_);
+        /* distance to the nearest landmark so far, unreachable for nodes no landmark reaches */
+        std::vector<Length> nearest(size_, unreachable);
+        IndexedHeap<Length, std::less<>, 4, Index> heap(size_);
+
+        /* the first landmark is the node farthest from node 0, which is at the border */
+        Index next = 0;
+        if (count > 0) {
+            shortest_distances(graph, get_edge_length, 0, heap, from_landmark);
+            next = farthest(from_landmark);
+        }
+
+        for (uint64_t l = 0; l < count; l++) {
+            landmarks_.push_back(next);
+            shortest_distances(graph, get_edge_length, next, heap, from_landmark);
+            for (uint64_t v = 0; v < size_; v++) {
+                dist_[v * count + l] = from_landmark[v];
+                nearest[v] = std::min(nearest[v], from_landmark[v]);
+            }
+            /* farthest from all landmarks so far. Nodes no landmark reaches come first,
+               so every component gets a landmark before any gets a second */
+            next = farthest(nearest);
+        }
+    }
+
+    /// @return node with the largest distance, the first of equal ones
+    static Index farthest(const std::vector<Length>& dist) {
+        return std::max_element(dist.begin(), dist.end()) - dist.begin();
+    }
+
+    /// @brief Dijkstra from source to all nodes
+    /// @param dist receives the distance of every node, unreachable for the ones not reached
+    template <Graph G, typename EdgeLength>
+    static void shortest_distances(const G& graph, EdgeLength& get_edge_length, const Index source,
+                                   IndexedHeap<Length, std::less<>, 4, Index>& heap, std::vector<Length>& dist)
+    {
+        std::fill(dist.begin(), dist.end(), unreachable);
+        dist[source] = Length();
+        heap.push(source, Length());
+        while (!heap.empty()) {
+            const auto [node, d] = heap.pop();
+            const EdgeView auto& edges = graph.edges(node);
+            for (uint64_t i = 0; i < edges.size(); i++) {
+                const Index e = edges[i];
+                const Length nd = d + Length(edge_length(graph, get_edge_length, node, i, e));
+                if (!(nd < dist[e])) continue;
+                dist[e] = nd;
+                heap.push_or_decrease(e, nd);
+            }
+        }
+    }
+
+    uint64_t size_ = 0;
+    std::vector<Index> landmarks_;
+    std::vector<Length> dist_; /* distance from landmark l to node v at v * count + l */
+};
+
+} // namespace mazes
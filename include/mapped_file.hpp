@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <optional>
+#include <filesystem>
+#include <cassert>
+
+namespace mazes {
+
+/// Read-only memory mapping of a whole file. The pages are loaded by the OS on first access,
+/// so opening is O(1) and reading streams the file without copying it into the process.
+/// Move-only, unmaps on destruction.
+class MappedFile {
+public:
+    enum class Access {
+        read_only,
+        copy_on_write /* writable, writes go to private copies of the touched pages, never to the file */
+    };
+
+    /// @return mapping of the file at path, or nullopt if it cannot be opened or mapped
+    static std::optional<MappedFile> open(const std::filesystem::path& path, Access access = Access::read_only);
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    /// @return contents of the file, valid as long as the MappedFile lives
+    std::span<const char> data() const noexcept { return { data_, size_ }; }
+
+    /// @return contents of the file, which must be mapped with Access::copy_on_write
+    std::span<char> mutable_data() noexcept {
+        assert(access_ == Access::copy_on_write);
+        return { data_, size_ };
+    }
+
+    uint64_t size() const noexcept { return size_; }
+
+private:
+    MappedFile(char* data, uint64_t size, Access access) noexcept
+        : data_{data}, size_{size}, access_{access} { };
+
+    char* data_;
+    uint64_t size_;
+    Access access_;
+};
+
+} // namespace mazes
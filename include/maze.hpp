@@ -9,6 +9,7 @@
 #include <compare>
 #include <cassert>
 #include <iostream>
+#include <utility>
 
 #include "point.hpp"
 
@@ -31,6 +32,13 @@ struct Maze {
         std::copy(beg, end, cells_.begin());
     }
 
+    /// @param cells w * h cells in row order, taken over without copying
+    Maze(uint32_t w, uint32_t h, std::vector<uint8_t>&& cells) noexcept
+            : width { w }, height { h }, cells_ { std::move(cells) }
+    {
+        assert(cells_.size() == uint64_t(w) * h);
+    }
+
     template <std::convertible_to<uint32_t> Sz, std::convertible_to<uint8_t> ... Vs>
     constexpr Maze(Sz w, Sz h, Vs ... vs)
             : width    { static_cast<uint32_t>(w) },
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <optional>
+#include <filesystem>
+#include <span>
+#include <array>
+#include <cstdint>
+
+#include <maze.hpp>
+#include <bitmaze.hpp>
+
+namespace mazes {
+
+/// Text maze format: one row per line, cells as single digits separated by ',' (e.g. 101x101.txt).
+/// Whitespace and ',' are separators, there is one between any two cells.
+/// The width is the number of cells in the first line.
+
+/// @brief Parse the cells of a text maze
+/// @return nullopt if text contains other characters, or its cells do not form a rectangle
+std::optional<Maze> parse_maze(std::span<const char> text);
+
+/// @brief Memory-map and parse a text maze file
+/// @return nullopt if the file cannot be read or is not a valid text maze
+std::optional<Maze> load_maze(const std::filesystem::path& path);
+
+/// @brief Memory-map and parse a text maze file straight into one bit per cell
+/// @return nullopt if the file cannot be read, is not a valid text maze, or has cells other than path and wall
+std::optional<BitMaze> load_bitmaze(const std::filesystem::path& path);
+
+/// @return hash of the cells and dimensions of maze. Equal to the checksum in the header of its binary maze file
+uint64_t maze_hash(const BitMaze& maze);
+
+/// Binary maze format: this header, followed by the words of a BitMaze (height rows of stride words).
+/// All fields little endian. The header is a multiple of 8 bytes, so the rows of a mapped file are word aligned.
+struct BinaryMazeHeader {
+    static constexpr std::array<char, 8> magic_value = { 'M', 'A', 'Z', 'E', 'B', 'I', 'T', 'S' };
+    static constexpr uint32_t current_version = 1;
+    static constexpr uint32_t no_opening = UINT32_MAX;
+
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t width, height;
+    uint32_t stride;   /* words per row */
+    uint32_t entry_x;  /* x of the hole in the top row, or no_opening */
+    uint32_t exit_x;   /* x of the hole in the bottom row, or no_opening */
+    uint64_t checksum; /* maze_hash() of the maze */
+};
+static_assert(sizeof(BinaryMazeHeader) == 40 && sizeof(BinaryMazeHeader) % sizeof(BitMaze::Word) == 0);
+
+/// @brief Write maze in the binary maze format
+/// @return false if the file could not be written
+bool save_binary_maze(const BitMaze& maze, const std::filesystem::path& path);
+
+/// @brief Read the header of a binary maze file, without mapping the rows
+/// @return nullopt if the file cannot be read or has no header of the current version
+std::optional<BinaryMazeHeader> load_binary_maze_header(const std::filesystem::path& path);
+
+/// @brief Map a binary maze file: the maze is a view of the mapped rows, there is no parsing and no copy.
+///        The mapping is copy-on-write, so changing the maze never changes the file.
+/// @param verify_checksum whether to read all rows once to compare them with the checksum of the header
+/// @return nullopt if the file cannot be mapped, has a wrong header or size, path bits after the last cell
+///         of a row, or a wrong checksum
+std::optional<BitMaze> load_binary_maze(const std::filesystem::path& path, bool verify_checksum = true);
+
+} // namespace mazes
@@ -3,18 +3,40 @@
 #pragma once
 
 #include <maze.hpp>
+#include <bitmaze.hpp>
 #include <directedgraph.hpp>
 
 namespace mazes {
-// Graph type used for mazes
-using MazeGraph = DirectedGraph<Point, 4>;
+// Graph type used for mazes. No maze has 2^32 decision points -> 32 bit indices
+using MazeGraph = DirectedGraph<Point, 4, uint32_t>;
+
+// Read-only compressed form of MazeGraph (MazeGraph::freeze()), for solving and caching
+using MazeCsrGraph = CsrGraph<Point, MazeGraph::IndexType>;
+
+// MazeCsrGraph with the length of each corridor (in cells) stored with its edge
+using WeightedMazeGraph = WeightedCsrGraph<Point, MazeGraph::IndexType, uint32_t>;
 
 /// @brief A valid maze is defined by having one hole in the top, one in the bottom,
 ///        and completely intact walls on the left and right
 bool valid_maze(const Maze& maze);
+bool valid_maze(const BitMaze& maze);
 
 
 /// @brief Construct graph from given maze
 /// @return graph with nodes and edges corresponding to decision points in maze
 MazeGraph graph_from_maze(const Maze& maze);
+MazeGraph graph_from_maze(const BitMaze& maze);
+
+/// @brief Construct graph from given maze, with corridor lengths
+/// @return graph_from_maze with the number of steps between the nodes of each edge stored with the edge
+WeightedMazeGraph weighted_graph_from_maze(const Maze& maze);
+WeightedMazeGraph weighted_graph_from_maze(const BitMaze& maze);
+
+/// @return graph with the corridor lengths of its edges stored, e.g. for a graph from the graph cache
+WeightedMazeGraph with_corridor_lengths(const MazeCsrGraph& graph);
+
+/// @brief graph_from_maze on nthreads horizontal bands of rows, built concurrently and stitched together
+/// @param nthreads number of threads, 0 for one per hardware thread
+/// @return the same graph as graph_from_maze, with the same node numbering
+MazeGraph graph_from_maze_parallel(const BitMaze& maze, uint32_t nthreads = 0);
 } // namespace mazes
\ No newline at end of file
@@ -2,5 +2,12 @@
 
 #pragma once
 
+#include <span>
+#include <type_traits>
+
+template <typename Graph>
+using PathType = std::decay_t<Graph>::Path;
+
+/// Path owned by a SearchWorkspace, valid until its next search
 template <typename Graph>
-using PathType = std::decay_t<Graph>::Path;
\ No newline at end of file
+using PathView = std::span<const typename std::decay_t<Graph>::IndexType>;
\ No newline at end of file
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <concepts>
+#include <type_traits>
+#include <variant>
+
+#include <indexed_heap.hpp>
+#include <bucket_queue.hpp>
+
+namespace mazes {
+
+/// Buffers of a search, reused from query to query: once a workspace has seen a graph,
+/// a search on it does not allocate. Marks are generation stamps -> starting a new search is O(1),
+/// values stored per node (e.g. pathlen) are only valid for marked nodes and never need clearing.
+/// One workspace per thread: searches must not share a workspace at the same time.
+/// \tparam Index type of node indices of the graph
+/// \tparam Distance type of pathlengths of Dijkstra and A*
+template <std::unsigned_integral Index, typename Distance = long>
+class SearchWorkspace {
+    template <typename D, typename Value>
+    struct radix_of { using type = std::monostate; };
+
+    template <std::integral D, typename Value>
+    struct radix_of<D, Value> { using type = RadixHeap<D, Value>; };
+
+public:
+    using IndexType = Index;
+    using DistanceType = Distance;
+
+    /// Element of a BFS queue or DFS stack
+    struct Node {
+        Index node; /* node of graph */
+        Index via_elmidx; /* index of the element it was reached from */
+    };
+
+    /// Finished element of Dijkstra or A*
+    struct Step {
+        Index node; /* node of graph */
+        Index via_elmidx; /* index into finished elements */
+        Distance pathlen; /* combined pathlength up until node */
+    };
+
+    /// Key of an open node in the heap of Dijkstra: ordered by pathlen only
+    struct PathKey {
+        Distance pathlen; /* combined pathlength up until node */
+        Index via_elmidx; /* index into finished elements */
+
+        constexpr friend bool operator<(const PathKey& a, const PathKey& b) noexcept {
+            return a.pathlen < b.pathlen;
+        }
+    };
+
+    /// Key of an open node in the heap of A*
+    struct HeuristicKey {
+        Distance total_heuristic; /* f = pathlen + distance to finish */
+        Distance pathlen; /* g: combined pathlength up until node */
+        Index via_elmidx; /* index into finished elements */
+
+        /* smallest f first. On ties the node furthest along its path (larger g) first,
+           which follows a corridor to its end instead of expanding every node of equal f */
+        constexpr friend bool operator<(const HeuristicKey& a, const HeuristicKey& b) noexcept {
+            if (a.total_heuristic != b.total_heuristic)
+                return a.total_heuristic < b.total_heuristic;
+            return a.pathlen > b.pathlen;
+        }
+    };
+
+    using PathHeap = IndexedHeap<PathKey, std::less<>, 4, Index>;
+    using HeuristicHeap = IndexedHeap<HeuristicKey, std::less<>, 4, Index>;
+    /* radix heap only exists for integral distances */
+    using Radix = typename radix_of<Distance, Node>::type;
+
+    /// @brief Start a new search on a graph of graph_size nodes: no node is marked, all buffers are empty.
+    ///        Only allocates when the graph is larger than every graph before. Per node buffers that
+    ///        an algorithm does not use are not allocated.
+    constexpr void begin(const uint64_t graph_size) {
+        graph_size_ = graph_size;
+        if (marks_.size() < graph_size)
+            marks_.resize(graph_size, 0);
+        path_heap_.clear();
+        heuristic_heap_.clear();
+        if constexpr (std::is_integral_v<Distance>)
+            radix_.clear();
+        frontier_.clear();
+        finished_.clear();
+        path_.clear();
+        next_edge_.clear();
+
+        /* new generation -> all marks are stale. Clear them only when the counter wraps */
+        if (++generation_ == 0) {
+            std::fill(marks_.begin(), marks_.end(), 0);
+            generation_ = 1;
+        }
+    }
+
+    /// @return whether node was marked since begin
+    constexpr bool marked(const Index node) const noexcept { return marks_[node] == generation_; }
+    constexpr void mark(const Index node) noexcept { marks_[node] = generation_; }
+    constexpr void unmark(const Index node) noexcept { marks_[node] = 0; }
+
+    /// @return per node pathlen, only meaningful for nodes the algorithm has written
+    constexpr std::vector<Distance>& pathlen() {
+        if (pathlen_.size() < graph_size_) pathlen_.resize(graph_size_);
+        return pathlen_;
+    }
+    /// @return BFS queue / DFS stack
+    constexpr std::vector<Node>& frontier() noexcept { return frontier_; }
+    /// @return finished elements of Dijkstra / A*
+    constexpr std::vector<Step>& finished() noexcept { return finished_; }
+    /// @return empty Dijkstra heap for the nodes of the graph
+    constexpr PathHeap& path_heap() {
+        if (path_heap_.capacity() < graph_size_) path_heap_.reset(graph_size_);
+        return path_heap_;
+    }
+
+    /// @return empty A* heap for the nodes of the graph
+    constexpr HeuristicHeap& heuristic_heap() {
+        if (heuristic_heap_.capacity() < graph_size_) heuristic_heap_.reset(graph_size_);
+        return heuristic_heap_;
+    }
+    constexpr Radix& radix() noexcept { return radix_; }
+    /// @return path found by the last search
+    constexpr std::vector<Index>& path() noexcept { return path_; }
+    /// @return DFS: for each node of path(), position of the next edge to try
+    constexpr std::vector<Index>& next_edge() noexcept { return next_edge_; }
+
+private:
+    uint64_t graph_size_ = 0;
+    std::vector<uint32_t> marks_;
+    uint32_t generation_ = 0;
+
+    std::vector<Distance> pathlen_;
+    std::vector<Node> frontier_;
+    std::vector<Step> finished_;
+    PathHeap path_heap_;
+    HeuristicHeap heuristic_heap_;
+    Radix radix_;
+    std::vector<Index> path_;
+    std::vector<Index> next_edge_;
+};
+
+} // namespace mazes
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <utility>
+#include <optional>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <limits>
+#include <cassert>
+#include <concepts>
+
+#include <graph.hpp>
+#include <path_type.hpp>
+#include <search_workspace.hpp>
+
+namespace mazes {
+
+/// Output of solve_batch: the path of every query, stored back to back in one buffer per worker.
+/// Reusing an arena for the next batch keeps all its memory -> no allocations once it is large enough.
+/// \tparam Index type of the node indices in the paths
+template <std::unsigned_integral Index>
+class PathArena {
+public:
+    /// @brief Remove all paths and prepare for nqueries answers written by nworkers workers
+    void reset(const uint64_t nqueries, const uint64_t nworkers) {
+        entries_.assign(nqueries, { 0, 0, not_found });
+        if (segments_.size() < nworkers)
+            segments_.resize(nworkers);
+        for (Segment& seg : segments_)
+            seg.nodes.clear();
+    }
+
+    /// @return number of queries
+    uint64_t size() const noexcept { return entries_.size(); }
+
+    /// @return whether a path was found for query
+    bool found(const uint64_t query) const noexcept {
+        return entries_[query].length != not_found;
+    }
+
+    /// @return path of query in the order returned by the algorithm, empty if none was found
+    std::span<const Index> path(const uint64_t query) const noexcept {
+        const Entry& e = entries_[query];
+        if (e.length == not_found) return {};
+        return { segments_[e.worker].nodes.data() + e.begin, e.length };
+    }
+
+    /// @brief Store the path of query. Thread-safe for different workers and different queries
+    void store(const uint64_t worker, const uint64_t query, const std::span<const Index> path) {
+        assert(worker < segments_.size() && query < entries_.size());
+        std::vector<Index>& nodes = segments_[worker].nodes;
+        entries_[query] = { worker, nodes.size(), path.size() };
+        nodes.insert(nodes.end(), path.begin(), path.end());
+    }
+
+private:
+    static constexpr uint64_t not_found = std::numeric_limits<uint64_t>::max();
+
+    struct Entry {
+        uint64_t worker, begin, length;
+    };
+
+    /* own cache line per worker: workers append to their segments at the same time */
+    struct alignas(64) Segment {
+        std::vector<Index> nodes;
+    };
+
+    std::vector<Entry> entries_;
+    std::vector<Segment> segments_;
+};
+
+/// @brief Answer many (from, to) queries on one graph concurrently.
+///        Every worker thread has its own SearchWorkspace, so once a worker is warm its queries
+///        do not allocate, apart from growing its segment of out. Each worker also calls its own copy
+///        of algorithm. Queries are handed out in small chunks, so slow queries do not stall the other workers.
+/// \tparam Distance distance type of the workspaces, e.g. the edge length type of Dijkstra or A*
+/// \tparam Algorithm callable as algorithm(graph, from, to, workspace) -> std::optional<path>, the path
+///         being a PathView or PathType, e.g.
+///         [](const auto& g, uint64_t f, uint64_t t, auto& ws) { return BreadthFirst::search(g, f, t, ws); }
+/// @param out receives the path of query i as out.path(i)
+/// @param nthreads number of worker threads, 0 for one per hardware thread
+/// @return number of queries for which a path was found
+template <typename Distance = long, Graph G, typename Algorithm>
+uint64_t solve_batch(
+    const G& graph,
+    const std::span<const std::pair<uint64_t, uint64_t>> queries,
+    const Algorithm& algorithm,
+    PathArena<typename G::IndexType>& out,
+    uint32_t nthreads = 0)
+{
+    constexpr uint64_t chunk = 16; /* queries taken at once by a worker */
+
+    if (nthreads == 0)
+        nthreads = std::max(std::thread::hardware_concurrency(), 1u);
+    nthreads = std::clamp<uint64_t>((queries.size() + chunk - 1) / chunk, 1, nthreads);
+    out.reset(queries.size(), nthreads);
+
+    std::atomic<uint64_t> next { 0 };
+    std::atomic<uint64_t> found { 0 };
+    const auto worker = [&](const uint64_t w) {
+        Algorithm algo = algorithm;
+        SearchWorkspace<typename G::IndexType, Distance> workspace;
+        uint64_t nfound = 0;
+        while (true) {
+            const uint64_t begin = next.fetch_add(chunk, std::memory_order_relaxed);
+            if (begin >= queries.size()) break;
+
+            const uint64_t end = std::min(begin + chunk, queries.size());
+            for (uint64_t q = begin; q < end; q++) {
+                const auto path = algo(graph, queries[q].first, queries[q].second, workspace);
+                if (!path) continue;
+                out.store(w, q, PathView<G>(*path));
+                nfound++;
+            }
+        }
+        found.fetch_add(nfound, std::memory_order_relaxed);
+    };
+
+    if (nthreads == 1) {
+        worker(0);
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(nthreads);
+        for (uint64_t w = 0; w < nthreads; w++)
+            threads.emplace_back(worker, w);
+        for (std::thread& t : threads)
+            t.join();
+    }
+
+    return found.load();
+}
+
+} // namespace mazes
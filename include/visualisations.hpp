@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mazegraph.hpp>
+#include <graph.hpp>
 #include <path_type.hpp>
 #include <fbg.hpp>
 
@@ -45,7 +46,8 @@ struct VisualMazeGraph : fbg::Context {
    std::vector<fbg::Circle> nodes;
    std::vector<fbg::Line> lines;
 
-   VisualMazeGraph(fbg::Window& window, const Maze& maze, const MazeGraph& graph)
+   template <Graph G>
+   VisualMazeGraph(fbg::Window& window, const Maze& maze, const G& graph)
    {
       const float cellw { float(window.width()) / float(maze.width) };
       const float cellh { float(window.height()) / float(maze.height) };
@@ -93,7 +95,8 @@ struct VisualPath : fbg::Context {
     std::vector<fbg::Circle> circles;
     std::vector<fbg::Line> lines;
 
-    VisualPath(fbg::Window& window, const Maze& maze, const MazeGraph& graph, const PathType <MazeGraph>& path, const
+    template <Graph G>
+    VisualPath(fbg::Window& window, const Maze& maze, const G& graph, const PathType <G>& path, const
     fbg::Rgba col = { 0, 0, 255, 255 })
     {
         const float cellw { float(window.width()) / float(maze.width) };
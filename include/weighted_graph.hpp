@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <memory>
+#include <algorithm>
+#include <type_traits>
+#include <cassert>
+#include <concepts>
+
+#include <graph.hpp>
+#include <csrgraph.hpp>
+
+namespace mazes {
+
+/// Graph whose edges carry their length: edge_lengths(node)[i] is the length of edges(node)[i]
+template<typename G>
+concept WeightedGraph = Graph<G> && requires(const G graph, uint64_t node_index) {
+    typename G::LengthType;
+    { graph.edge_lengths(node_index) } -> std::convertible_to<std::span<const typename G::LengthType>>;
+    { graph.length(node_index, node_index) } -> std::convertible_to<typename G::LengthType>;
+};
+
+/// CsrGraph with a length stored for every edge, in the order of neighbors(),
+/// so searching it needs no edge length callback.
+/// Copies share the arrays, like CsrGraph.
+/// \tparam D Datatype stored in each node
+/// \tparam Index Type of node indices in edges and paths
+/// \tparam Length Type of edge lengths
+template<typename D, std::unsigned_integral Index, typename Length>
+class WeightedCsrGraph : public CsrGraph<D, Index> {
+public:
+    using LengthType = Length;
+
+    WeightedCsrGraph()
+            : CsrGraph<D, Index>(), lengths_{} {}
+
+    /// @param graph the edges, shared with graph
+    /// @param lengths length of each edge of graph, in the order of graph.neighbors()
+    WeightedCsrGraph(CsrGraph<D, Index> graph, std::vector<Length> lengths)
+            : CsrGraph<D, Index>(std::move(graph))
+    {
+        auto storage = std::make_shared<std::vector<Length>>(std::move(lengths));
+        lengths_ = *storage;
+        lengths_owner_ = std::move(storage);
+        assert(lengths_.size() == this->neighbors().size());
+    }
+
+    /// @brief Lengths of graph's edges as computed by get_edge_length(from, to), once per edge
+    template<typename EdgeLength>
+    WeightedCsrGraph(CsrGraph<D, Index> graph, EdgeLength&& get_edge_length)
+            : WeightedCsrGraph(graph, lengths_of(graph, get_edge_length)) {}
+
+    /// @return lengths of the outgoing edges of node at node_index, in the order of edges(node_index)
+    constexpr std::span<const Length> edge_lengths(const Index node_index) const noexcept {
+        return { lengths_.data() + this->offsets()[node_index],
+                 lengths_.data() + this->offsets()[node_index + 1] };
+    }
+
+    /// @return length of the edge from from to to, which must exist
+    constexpr Length length(const Index from, const Index to) const noexcept {
+        const auto edges = this->edges(from);
+        const auto it = std::find(edges.begin(), edges.end(), to);
+        assert(it != edges.end() && "no edge between from and to");
+        return edge_lengths(from)[it - edges.begin()];
+    }
+
+    /// @return lengths of all edges, in the order of neighbors()
+    constexpr std::span<const Length>
+    lengths() const noexcept { return lengths_; };
+
+private:
+    template<typename EdgeLength>
+    static std::vector<Length> lengths_of(const CsrGraph<D, Index>& graph, EdgeLength& get_edge_length) {
+        std::vector<Length> lengths;
+        lengths.reserve(graph.neighbors().size());
+        for (uint64_t n = 0; n < graph.size(); n++)
+            for (const Index e : graph.edges(n))
+                lengths.push_back(get_edge_length(n, e));
+        return lengths;
+    }
+
+    std::span<const Length> lengths_;
+    std::shared_ptr<const void> lengths_owner_;
+};
+
+/// Edge length callback that reads the lengths stored in a WeightedGraph.
+/// Dijkstra and AStar recognize it and read the length at the position of the edge
+/// instead of calling it -> no lookup per relaxation.
+template<WeightedGraph G>
+struct StoredLengths {
+    const G& graph;
+
+    constexpr typename G::LengthType operator()(const uint64_t from, const uint64_t to) const noexcept {
+        return graph.length(from, to);
+    }
+};
+
+template<typename F>
+inline constexpr bool is_stored_lengths = false;
+
+template<typename G>
+inline constexpr bool is_stored_lengths<StoredLengths<G>> = true;
+
+/// @return length of the i-th outgoing edge of node, which leads to e
+template<Graph G, typename EdgeLength>
+constexpr auto edge_length(const G& graph, EdgeLength& get_edge_length,
+                           const uint64_t node, const uint64_t i, const uint64_t e) noexcept
+{
+    if constexpr (is_stored_lengths<std::remove_cvref_t<EdgeLength>>)
+        return graph.edge_lengths(node)[i];
+    else
+        return get_edge_length(node, e);
+}
+
+} // namespace mazes
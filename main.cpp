@@ -1,64 +1,63 @@
 #include <fbg.hpp>
 #include <mazegraph.hpp>
+#include <maze_io.hpp>
+#include <graph_cache.hpp>
 #include <visualisations.hpp>
 #include <algorithms/depth_first.hpp>
 #include <algorithms/breadth_first.hpp>
 #include <algorithms/dijkstra.hpp>
 #include <algorithms/astar.hpp>
 #include <find_all_paths.hpp>
+#include <landmarks.hpp>
+#include <distance_field.hpp>
 
 #include <chrono>
+#include <filesystem>
+#include <optional>
 
-int main() {
+int main(int argc, char** argv) {
     using namespace mazes;
 
-    const Maze maze(101, 101, {
-        #include "101x101.txt"
-    });
+    /* maze file as first argument, default is the 101x101 maze of the repository */
+    const std::filesystem::path maze_path = argc > 1 ? argv[1] : MAZES_DATA_DIR "/101x101.txt";
+    std::optional<Maze> loaded = load_maze(maze_path);
+    if (!loaded) {
+        std::cerr << "Could not load maze from " << maze_path << "\n";
+        return 1;
+    }
+    const Maze maze = std::move(*loaded);
 
     using namespace std::chrono;
     // microseconds
     time_point<high_resolution_clock, duration<double, std::ratio<1, 1000000>>> startTime, endTime;
+    /* graph is built once per maze, later runs map it from the cache */
+    const std::filesystem::path cache_dir = std::filesystem::temp_directory_path() / "mazes-graph-cache";
     startTime = high_resolution_clock::now();
-    const MazeGraph graph = graph_from_maze(maze);
+    const MazeCsrGraph graph = cached_graph_from_maze(BitMaze(maze), cache_dir);
     endTime = high_resolution_clock::now();
-    std::cout << "Created graph with " << graph.nodes().size() << " nodes in " << endTime - startTime << ".\n";
+    std::cout << "Got graph with " << graph.size() << " nodes ("
+              << graph.nodes().size_bytes() + graph.offsets().size_bytes() + graph.neighbors().size_bytes()
+              << " bytes, " << sizeof(MazeCsrGraph::IndexType) << " byte indices) in " << endTime - startTime << ".\n";
     const uint64_t from = 0, to = graph.size() - 1;
 
-    const auto map = [](float x, float fmin, float fmax, float tmin, float tmax) {
-        const float fr = fmax - fmin;
-        const float tr = tmax - tmin;
-        return ((x - fmin) * tr) / fr + tmin;
-    };
-
-    float maxdiffx = graph.node(to).x;
-    float maxdiffy = graph.node(to).y;
-    float maxdiffsz = maxdiffx * maxdiffx + maxdiffy * maxdiffy;
-
-    const auto edgelen = [&map, maxdiffx, maxdiffy, &graph](const uint64_t a, const uint64_t b) -> float {
-        const Point p = graph.node(a), o = graph.node(b);
-        if (p.x == o.x)
-            return map(std::abs((long) p.y - (long) o.y), 0.0f, maxdiffy, 0.0f, 10.0f);
-        else
-            return map(std::abs((long) p.x - (long) o.x), 0.0f, maxdiffx, 0.0f, 10.0f);
-    };
+    /* corridor lengths are stored with the edges -> Dijkstra and A* need no edge length callback */
+    const WeightedMazeGraph wgraph = with_corridor_lengths(graph);
 
-    const auto dist = [&map, &graph, maxdiffsz, endp = graph.node(to)](const uint64_t n) -> float {
-        const Point diff = {
-            endp.x - graph.node(n).x,
-            endp.y - graph.node(n).y
-        };
-        const float v = diff.x * diff.x + diff.y * diff.y;
-        return map(v, 0.0f, maxdiffsz, 0.0f, 1000.0f);
-    };
+    /* distances from landmarks bound the distance to the exit along the corridors, not through the walls
+       -> never overestimates, so A* finds the shortest path, and it expands far fewer nodes than with a manhattan distance */
+    startTime = high_resolution_clock::now();
+    const Landmarks<MazeCsrGraph::IndexType, WeightedMazeGraph::LengthType> landmarks(wgraph, std::min<uint64_t>(8, graph.size()));
+    endTime = high_resolution_clock::now();
+    std::cout << "Landmarks took " << endTime - startTime << "\n";
+    const auto dist = landmarks.heuristic(to);
 
     startTime = high_resolution_clock::now();
-    const auto dpath = Dijkstra::search<float>(graph, from, to, edgelen).value();
+    const auto dpath = Dijkstra::search(wgraph, from, to).value();
     endTime = high_resolution_clock::now();
     std::cout << "Dijkstra took " << endTime - startTime << "\n";
 
     startTime = high_resolution_clock::now();
-    const auto apath = AStar::search<float>(graph, from, to, edgelen, dist).value();
+    const auto apath = AStar::search(wgraph, from, to, dist).value();
     endTime = high_resolution_clock::now();
     std::cout << "A* took " << endTime - startTime << "\n";
 
@@ -78,8 +77,21 @@ int main() {
     VisualMaze vmaze(win, maze);
     win.attach(vmaze);
 
-    /* should both be shortest path */
-    assert(std::equal(apath.begin(), apath.end(), dpath.begin(), dpath.end()));
+    /* should both be shortest path, of equal length but not necessarily the same on mazes with loops */
+    const auto path_length = [&wgraph](const MazeCsrGraph::Path& path) {
+        uint64_t len = 0;
+        for (uint64_t i = 1; i < path.size(); i++)
+            len += wgraph.length(path[i - 1], path[i]);
+        return len;
+    };
+    assert(path_length(apath) == path_length(dpath));
+
+    /* one Dijkstra from the exit, then the route from any node is a lookup of next hops */
+    startTime = high_resolution_clock::now();
+    const DistanceField field(wgraph, to);
+    endTime = high_resolution_clock::now();
+    std::cout << "Distance field took " << endTime - startTime << "\n";
+    assert(field.distance(from) == path_length(dpath));
 
     VisualMazeGraph vmaze_g(win, maze, graph);
     win.attach(vmaze_g);
@@ -0,0 +1,161 @@
+#include <distance_field.hpp>
+
+#include <bit>
+#include <cassert>
+#include <fstream>
+
+/* the distance field file stores the arrays as they are in memory */
+static_assert(std::endian::native == std::endian::little);
+
+mazes::DistanceField::DistanceField(const WeightedMazeGraph& graph, const uint64_t target) {
+    rebuild(graph, target);
+}
+
+mazes::DistanceField::DistanceField(const Maze& maze, const Point target) {
+    rebuild(maze, target);
+}
+
+mazes::DistanceField::DistanceField(const BitMaze& maze, const Point target) {
+    rebuild(maze, target);
+}
+
+void mazes::DistanceField::begin(const Domain domain, const uint64_t n, const uint64_t target) {
+    assert(target < n && n <= none);
+    domain_ = domain;
+    target_ = Index(target);
+    distance_.assign(n, unreachable);
+    next_.assign(n, none);
+    distance_[target] = 0;
+}
+
+void mazes::DistanceField::rebuild(const WeightedMazeGraph& graph, const uint64_t target) {
+    begin(Domain::nodes, graph.size(), target);
+
+    /* Dijkstra from the target. Edges go both ways with the same length, so the distance from the target
+       is the distance to it, and the node a node was reached from is its next step */
+    heap_.reset(graph.size());
+    heap_.push(Index(target), 0);
+    while (!heap_.empty()) {
+        const auto [node, d] = heap_.pop();
+        const auto edges = graph.edges(node);
+        const std::span<const uint32_t> lengths = graph.edge_lengths(node);
+        for (uint64_t i = 0; i < edges.size(); i++) {
+            const Index e = edges[i];
+            const uint32_t nd = d + lengths[i];
+            if (!(nd < distance_[e])) continue;
+            distance_[e] = nd;
+            next_[e] = node;
+            heap_.push_or_decrease(e, nd);
+        }
+    }
+}
+
+template <typename MazeType>
+void mazes::DistanceField::rebuild_cells(const MazeType& maze, const Point target) {
+    assert(maze.path_at(target));
+    begin(Domain::cells, maze.size(), maze.index_of(target));
+
+    /* BFS from the target, level by level in one queue */
+    frontier_.clear();
+    frontier_.push_back(target_);
+    for (uint64_t head = 0; head < frontier_.size(); head++) {
+        const Index cell = frontier_[head];
+        const Point p = maze.point_of(cell);
+        const uint32_t d = distance_[cell] + 1;
+
+        const auto visit = [&](const Point o) {
+            const uint64_t c = maze.index_of(o);
+            if (distance_[c] != unreachable || !maze.path_at(o)) return;
+            distance_[c] = d;
+            next_[c] = cell;
+            frontier_.push_back(Index(c));
+        };
+        if (p.x > 0) visit({ p.x - 1, p.y });
+        if (p.x + 1 < maze.width) visit({ p.x + 1, p.y });
+        if (p.y > 0) visit({ p.x, p.y - 1 });
+        if (p.y + 1 < maze.height) visit({ p.x, p.y + 1 });
+    }
+}
+
+void mazes::DistanceField::rebuild(const Maze& maze, const Point target) {
+    rebuild_cells(maze, target);
+}
+
+void mazes::DistanceField::rebuild(const BitMaze& maze, const Point target) {
+    rebuild_cells(maze, target);
+}
+
+bool mazes::DistanceField::valid() const noexcept {
+    if (target_ >= size() || distance_[target_] != 0 || next_[target_] != none) return false;
+    for (uint64_t i = 0; i < size(); i++) {
+        if (i == target_) continue;
+        if (distance_[i] == unreachable) {
+            if (next_[i] != none) return false;
+            continue;
+        }
+        /* the distance strictly decreases along next -> every chase ends at the target */
+        if (next_[i] >= size() || !(distance_[next_[i]] < distance_[i])) return false;
+    }
+    return true;
+}
+
+bool mazes::DistanceField::path(const uint64_t from, std::vector<Index>& out) const {
+    out.clear();
+    if (!reachable(from)) return false;
+    for (Index e = Index(from); e != none; e = next_[e])
+        out.push_back(e);
+    assert(out.back() == target_);
+    return true;
+}
+
+std::optional<std::vector<mazes::DistanceField::Index>> mazes::DistanceField::path(const uint64_t from) const {
+    std::vector<Index> out;
+    if (!path(from, out)) return std::nullopt;
+    return out;
+}
+
+bool mazes::save_distance_field(const DistanceField& field, const uint64_t maze_hash, const std::filesystem::path& path) {
+    DistanceFieldHeader header {};
+    header.magic = DistanceFieldHeader::magic_value;
+    header.version = DistanceFieldHeader::current_version;
+    header.index_bytes = sizeof(DistanceField::Index);
+    header.maze_hash = maze_hash;
+    header.size = field.size();
+    header.target = field.target();
+    header.domain = uint32_t(field.domain());
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(field.distance_.data()), std::streamsize(field.size() * sizeof(uint32_t)));
+    out.write(reinterpret_cast<const char*>(field.next_.data()), std::streamsize(field.size() * sizeof(DistanceField::Index)));
+    return bool(out.flush());
+}
+
+std::optional<mazes::DistanceField> mazes::load_distance_field(const std::filesystem::path& path, const uint64_t maze_hash) {
+    std::ifstream in(path, std::ios::binary);
+    DistanceFieldHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return std::nullopt;
+    if (header.magic != DistanceFieldHeader::magic_value
+        || header.version != DistanceFieldHeader::current_version
+        || header.index_bytes != sizeof(DistanceField::Index)
+        || header.maze_hash != maze_hash
+        || header.domain > uint32_t(DistanceField::Domain::cells)
+        || header.target >= header.size)
+        return std::nullopt;
+
+    std::error_code ec;
+    const uint64_t file_size = std::filesystem::file_size(path, ec);
+    if (ec || file_size != sizeof(header) + header.size * (sizeof(uint32_t) + sizeof(DistanceField::Index)))
+        return std::nullopt;
+
+    DistanceField field;
+    field.domain_ = DistanceField::Domain(header.domain);
+    field.target_ = header.target;
+    field.distance_.resize(header.size);
+    field.next_.resize(header.size);
+    if (!in.read(reinterpret_cast<char*>(field.distance_.data()), std::streamsize(header.size * sizeof(uint32_t)))
+        || !in.read(reinterpret_cast<char*>(field.next_.data()), std::streamsize(header.size * sizeof(DistanceField::Index))))
+        return std::nullopt;
+    if (!field.valid()) return std::nullopt;
+    return field;
+}
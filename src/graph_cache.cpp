@@ -0,0 +1,143 @@
+#include <graph_cache.hpp>
+
+#include <mapped_file.hpp>
+#include <maze_io.hpp>
+
+#include <cstring>
+#include <cstdio>
+#include <bit>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <functional>
+#include <type_traits>
+
+#include <unistd.h>
+
+namespace {
+using namespace mazes;
+using Index = MazeGraph::IndexType;
+
+static_assert(std::endian::native == std::endian::little);
+static_assert(std::is_trivially_copyable_v<Point> && sizeof(Point) == 8);
+
+/// Byte offsets of the arrays in a graph cache file
+struct CacheLayout {
+    uint64_t nodes, offsets, neighbors, end;
+};
+
+constexpr CacheLayout layout_of(const uint64_t nnodes, const uint64_t nedges) noexcept {
+    CacheLayout l {};
+    l.nodes = sizeof(GraphCacheHeader);
+    l.offsets = l.nodes + nnodes * sizeof(Point);
+    l.neighbors = l.offsets + (nnodes + 1) * sizeof(uint64_t);
+    l.end = l.neighbors + nedges * sizeof(Index);
+    return l;
+}
+
+/// @return whether offsets ascend from 0 to neighbors.size() and every neighbor is a node,
+///         so that no edge of the graph reads outside of the arrays
+bool valid_arrays(const std::span<const uint64_t> offsets, const std::span<const Index> neighbors) noexcept {
+    const uint64_t nnodes = offsets.size() - 1;
+    if (offsets.front() != 0 || offsets.back() != neighbors.size()) return false;
+    for (uint64_t i = 0; i < nnodes; i++)
+        if (offsets[i] > offsets[i + 1]) return false;
+    for (const Index n : neighbors)
+        if (n >= nnodes) return false;
+    return true;
+}
+
+template <typename T>
+void write_array(std::ofstream& out, const std::span<const T> array) {
+    out.write(reinterpret_cast<const char*>(array.data()), std::streamsize(array.size_bytes()));
+}
+} // namespace
+
+bool mazes::save_graph_cache(const MazeCsrGraph& graph, const uint64_t maze_hash, const std::filesystem::path& path) {
+    GraphCacheHeader header {};
+    header.magic = GraphCacheHeader::magic_value;
+    header.version = GraphCacheHeader::current_version;
+    header.index_bytes = sizeof(Index);
+    header.maze_hash = maze_hash;
+    header.nnodes = graph.size();
+    header.nedges = graph.neighbors().size();
+
+    /* write to a temporary file and rename: readers never see a half written cache,
+       also when several processes build the same graph at once */
+    std::filesystem::path tmp = path;
+    tmp += ".tmp." + std::to_string(::getpid()) + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        write_array(out, graph.nodes());
+        write_array(out, graph.offsets());
+        write_array(out, graph.neighbors());
+        if (!out.flush()) {
+            std::error_code ec;
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) std::filesystem::remove(tmp, ec);
+    return !ec;
+}
+
+std::optional<mazes::MazeCsrGraph> mazes::load_graph_cache(const std::filesystem::path& path, const uint64_t maze_hash) {
+    std::optional<MappedFile> file = MappedFile::open(path);
+    if (!file || file->size() < sizeof(GraphCacheHeader)) return std::nullopt;
+
+    GraphCacheHeader header;
+    std::memcpy(&header, file->data().data(), sizeof(header));
+    if (header.magic != GraphCacheHeader::magic_value
+        || header.version != GraphCacheHeader::current_version
+        || header.index_bytes != sizeof(Index)
+        || header.maze_hash != maze_hash)
+        return std::nullopt;
+
+    /* bound the counts by the file size first, so that the layout cannot overflow */
+    if (header.nnodes > file->size() / sizeof(Point) || header.nedges > file->size() / sizeof(Index))
+        return std::nullopt;
+    const CacheLayout layout = layout_of(header.nnodes, header.nedges);
+    if (file->size() != layout.end) return std::nullopt;
+
+    /* the graph owns the mapping -> lives as long as the graph or one of its copies */
+    auto mapping = std::make_shared<const MappedFile>(std::move(*file));
+    const char* const base = mapping->data().data();
+    const std::span<const Point> nodes { reinterpret_cast<const Point*>(base + layout.nodes), header.nnodes };
+    const std::span<const uint64_t> offsets { reinterpret_cast<const uint64_t*>(base + layout.offsets), header.nnodes + 1 };
+    const std::span<const Index> neighbors { reinterpret_cast<const Index*>(base + layout.neighbors), header.nedges };
+    /* a corrupt file is rebuilt by cached_graph_from_maze instead of crashing a search */
+    if (!valid_arrays(offsets, neighbors)) return std::nullopt;
+
+    return MazeCsrGraph(nodes, offsets, neighbors, std::move(mapping));
+}
+
+std::filesystem::path mazes::graph_cache_path(const std::filesystem::path& cache_dir, const uint64_t maze_hash) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.mgraph", static_cast<unsigned long long>(maze_hash));
+    return cache_dir / name;
+}
+
+mazes::MazeCsrGraph mazes::cached_graph_from_maze(
+        const BitMaze& maze, const uint64_t maze_hash, const std::filesystem::path& cache_dir) {
+    const std::filesystem::path path = graph_cache_path(cache_dir, maze_hash);
+    if (std::optional<MazeCsrGraph> cached = load_graph_cache(path, maze_hash))
+        return std::move(*cached);
+
+    MazeCsrGraph graph = graph_from_maze(maze).freeze();
+
+    /* failing to store only costs the next run a rebuild */
+    std::error_code ec;
+    std::filesystem::create_directories(cache_dir, ec);
+    save_graph_cache(graph, maze_hash, path);
+    return graph;
+}
+
+mazes::MazeCsrGraph mazes::cached_graph_from_maze(const BitMaze& maze, const std::filesystem::path& cache_dir) {
+    return cached_graph_from_maze(maze, maze_hash(maze), cache_dir);
+}
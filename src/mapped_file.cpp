@@ -0,0 +1,51 @@
+#include <mapped_file.hpp>
+
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+std::optional<mazes::MappedFile> mazes::MappedFile::open(const std::filesystem::path& path, const Access access) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return std::nullopt;
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return std::nullopt;
+    }
+
+    const uint64_t size = st.st_size;
+    if (size == 0) { /* mmap of length 0 fails -> empty mapping */
+        ::close(fd);
+        return MappedFile(nullptr, 0, access);
+    }
+
+    const int prot = access == Access::copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* addr = ::mmap(nullptr, size, prot, MAP_PRIVATE, fd, 0);
+    ::close(fd); /* mapping stays valid after closing */
+    if (addr == MAP_FAILED) return std::nullopt;
+
+    /* read front to back -> aggressive read-ahead */
+    ::madvise(addr, size, MADV_SEQUENTIAL);
+    return MappedFile(static_cast<char*>(addr), size, access);
+}
+
+mazes::MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_{std::exchange(other.data_, nullptr)}, size_{std::exchange(other.size_, 0)}, access_{other.access_} { }
+
+mazes::MappedFile& mazes::MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        if (data_) ::munmap(data_, size_);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        access_ = other.access_;
+    }
+    return *this;
+}
+
+mazes::MappedFile::~MappedFile() {
+    if (data_) ::munmap(data_, size_);
+}
@@ -0,0 +1,273 @@
+#include <maze_io.hpp>
+
+#include <mapped_file.hpp>
+#include <checksum.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <bit>
+#include <cstring>
+#include <cassert>
+#include <fstream>
+#include <memory>
+
+/* the binary maze format and the SWAR tokenizer read little endian words */
+static_assert(std::endian::native == std::endian::little);
+
+namespace {
+using namespace mazes;
+
+/// Dimensions of a text maze
+struct TextShape {
+    uint32_t width, height;
+};
+
+/* digits are cells, everything else must be a separator */
+constexpr bool is_cell(const char c) noexcept { return uint8_t(c - '0') < 10; }
+constexpr bool is_separator(const char c) noexcept {
+    return (c == ',') | (c == '\n') | (c == ' ') | (c == '\r') | (c == '\t');
+}
+
+/// @return x of the only path cell in row y, or BinaryMazeHeader::no_opening
+uint32_t find_opening(const BitMaze& maze, const uint32_t y) {
+    for (uint32_t w = 0; w < maze.stride; w++)
+        if (const BitMaze::Word word = maze.row(y)[w]; word != 0)
+            return w * BitMaze::word_bits + std::countr_zero(word);
+    return BinaryMazeHeader::no_opening;
+}
+
+/// @return whether the padding bits after the last cell of every row are 0 (wall), as BitMaze requires.
+///        Reads one word per row, also when the checksum is not verified
+bool valid_padding(const BitMaze& maze) noexcept {
+    const uint32_t used = maze.width % BitMaze::word_bits;
+    if (used == 0) return true;
+    const BitMaze::Word padding = ~BitMaze::Word(0) << used;
+    for (uint32_t y = 0; y < maze.height; y++)
+        if (maze.row(y)[maze.stride - 1] & padding) return false;
+    return true;
+}
+
+/// @return whether header is of the current version and describes a maze of file_size bytes in total
+bool valid_header(const BinaryMazeHeader& header, const uint64_t file_size) {
+    return header.magic == BinaryMazeHeader::magic_value
+        && header.version == BinaryMazeHeader::current_version
+        && header.stride == BitMaze::stride_of(header.width)
+        && file_size == sizeof(BinaryMazeHeader)
+                        + uint64_t(header.stride) * header.height * sizeof(BitMaze::Word);
+}
+
+/// @return number of digit characters in text, 8 bytes at a time
+uint64_t count_cells(const std::span<const char> text) {
+    constexpr uint64_t ones = 0x0101010101010101;
+    constexpr uint64_t high = 0x8080808080808080; /* top bit of each byte */
+
+    const char* const data = text.data();
+    const uint64_t size = text.size();
+    uint64_t n = 0, i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        /* per byte, 7 bit value + offset cannot carry into the next byte:
+           top bit of ge -> >= '0', top bit of gt -> > '9', top bit of word -> not ascii */
+        const uint64_t low = word & ~high;
+        const uint64_t ge = low + ones * (0x80 - '0');
+        const uint64_t gt = low + ones * (0x80 - '9' - 1);
+        n += std::popcount(ge & ~gt & ~word & high);
+    }
+    for (; i < size; i++)
+        n += is_cell(data[i]);
+    return n;
+}
+
+/// @return width and height of the maze in text, nullopt if its cells do not form a rectangle:
+///         every line with cells must have as many as the first line
+std::optional<TextShape> scan_shape(const std::span<const char> text) {
+    uint64_t width = 0, height = 0;
+    const char* const end = text.data() + text.size();
+    for (const char* line = text.data(); line < end; ) {
+        const char* const newline = static_cast<const char*>(std::memchr(line, '\n', end - line));
+        const char* const line_end = newline ? newline : end;
+        const uint64_t n = count_cells({ line, line_end });
+        if (line == text.data()) width = n;
+        if (n != 0) {
+            if (n != width) return std::nullopt;
+            height++;
+        }
+        line = line_end + 1;
+    }
+    if (width == 0) return std::nullopt;
+    if (width > std::numeric_limits<uint32_t>::max() || height > std::numeric_limits<uint32_t>::max())
+        return std::nullopt;
+    return TextShape { uint32_t(width), uint32_t(height) };
+}
+
+/// @brief Call on_cells(values, count) for the cells of text in order: the common "d,d,d,d," runs are
+///        decoded 8 bytes at a time (SWAR), everything else byte by byte.
+///        values holds cell values in its lowest count bytes.
+/// @return false if text contains characters other than digits and separators,
+///         or two digits without a separator between them (cells are single digits, "10" is no cell)
+template <typename F>
+bool tokenize(const std::span<const char> text, F on_cells) {
+    /* the word is seen as 4 16 bit lanes, the cell in the low byte and the ',' in the high byte of each */
+    constexpr uint64_t lanes  = 0x0001000100010001;
+    constexpr uint64_t high   = 0x8000800080008000; /* top bit of each lane */
+    constexpr uint64_t commas = 0x2C002C002C002C00;
+
+    const char* const data = text.data();
+    const uint64_t size = text.size();
+    uint64_t i = 0;
+    bool after_cell = false; /* last character was a digit -> the next one must not be */
+    while (i < size) {
+        if (!after_cell && i + 8 <= size) {
+            uint64_t word;
+            std::memcpy(&word, data + i, 8); /* little endian: first char is the lowest byte */
+
+            /* per lane: low byte >= '0' sets the top bit of the first sum, > '9' the top bit of the second */
+            const uint64_t low = word & ~(lanes * 0xFF00);
+            const bool all_digits = ((low + lanes * (0x8000 - '0')) & high) == high
+                                 && ((low + lanes * (0x8000 - '9' - 1)) & high) == 0;
+            if ((word & (lanes * 0xFF00)) == commas && all_digits) {
+                /* gather the 4 digits into the low 4 bytes */
+                uint64_t packed = low - lanes * '0';
+                packed = (packed | (packed >> 8))  & 0x0000FFFF0000FFFF;
+                packed = (packed | (packed >> 16)) & 0x00000000FFFFFFFF;
+                on_cells(packed, 4);
+                i += 8; /* ends on a ',' -> after_cell stays false */
+                continue;
+            }
+        }
+
+        if (is_cell(data[i])) {
+            if (after_cell) return false;
+            on_cells(uint64_t(uint8_t(data[i] - '0')), 1);
+            after_cell = true;
+        } else if (is_separator(data[i])) {
+            after_cell = false;
+        } else {
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
+} // namespace
+
+std::optional<mazes::Maze> mazes::parse_maze(const std::span<const char> text) {
+    const std::optional<TextShape> shape = scan_shape(text);
+    if (!shape) return std::nullopt;
+
+    const uint64_t ncells = uint64_t(shape->width) * shape->height;
+    /* + 4: four cells are always stored at once */
+    std::vector<uint8_t> cells(ncells + 4);
+    uint64_t n = 0;
+    const bool valid = tokenize(text, [&cells, &n](const uint64_t values, const uint64_t count) {
+        std::memcpy(cells.data() + n, &values, 4);
+        n += count;
+    });
+    if (!valid) return std::nullopt;
+    assert(n == ncells);
+    cells.resize(ncells);
+
+    return Maze(shape->width, shape->height, std::move(cells));
+}
+
+std::optional<mazes::Maze> mazes::load_maze(const std::filesystem::path& path) {
+    const std::optional<MappedFile> file = MappedFile::open(path);
+    if (!file) return std::nullopt;
+    return parse_maze(file->data());
+}
+
+std::optional<mazes::BitMaze> mazes::load_bitmaze(const std::filesystem::path& path) {
+    const std::optional<MappedFile> file = MappedFile::open(path);
+    if (!file) return std::nullopt;
+
+    const std::span<const char> text = file->data();
+    const std::optional<TextShape> shape = scan_shape(text);
+    if (!shape) return std::nullopt;
+
+    BitMaze maze(shape->width, shape->height);
+    uint32_t x = 0, y = 0;
+    std::span<BitMaze::Word> row = maze.row(0);
+    bool only_path_and_wall = true;
+    const bool valid = tokenize(text, [&](uint64_t values, const uint64_t count) {
+        const uint32_t bit = x % BitMaze::word_bits;
+        if (count == 4 && bit + 4 <= BitMaze::word_bits && x + 4 < maze.width) {
+            /* 4 cells within one word of the row: path (0) -> set bit, gathered with a multiply */
+            only_path_and_wall &= (values & 0xFEFEFEFE) == 0;
+            const uint64_t paths = ~values & 0x01010101;
+            row[x / BitMaze::word_bits] |= (((paths * 0x10204080) >> 28) & 0xF) << bit;
+            x += 4;
+            return;
+        }
+
+        for (uint64_t k = 0; k < count; k++, values >>= 8) {
+            const uint8_t cell = values & 0xFF;
+            only_path_and_wall &= (cell == Maze::path) | (cell == Maze::wall);
+            row[x / BitMaze::word_bits] |= BitMaze::Word(cell == Maze::path) << (x % BitMaze::word_bits);
+
+            if (++x == maze.width) { /* next row */
+                x = 0;
+                if (++y < maze.height) row = maze.row(y);
+            }
+        }
+    });
+    if (!valid || !only_path_and_wall) return std::nullopt;
+
+    return maze;
+}
+
+uint64_t mazes::maze_hash(const BitMaze& maze) {
+    return checksum(maze.words(), uint64_t(maze.width) << 32 | maze.height);
+}
+
+bool mazes::save_binary_maze(const BitMaze& maze, const std::filesystem::path& path) {
+    const std::span<const BitMaze::Word> words = maze.words();
+
+    BinaryMazeHeader header {};
+    header.magic = BinaryMazeHeader::magic_value;
+    header.version = BinaryMazeHeader::current_version;
+    header.width = maze.width;
+    header.height = maze.height;
+    header.stride = maze.stride;
+    header.entry_x = maze.height > 0 ? find_opening(maze, 0) : BinaryMazeHeader::no_opening;
+    header.exit_x = maze.height > 0 ? find_opening(maze, maze.height - 1) : BinaryMazeHeader::no_opening;
+    header.checksum = maze_hash(maze);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(words.data()), std::streamsize(words.size_bytes()));
+    return bool(out.flush());
+}
+
+std::optional<mazes::BinaryMazeHeader> mazes::load_binary_maze_header(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    BinaryMazeHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return std::nullopt;
+
+    std::error_code ec;
+    const uint64_t size = std::filesystem::file_size(path, ec);
+    if (ec || !valid_header(header, size)) return std::nullopt;
+    return header;
+}
+
+std::optional<mazes::BitMaze> mazes::load_binary_maze(const std::filesystem::path& path, const bool verify_checksum) {
+    std::optional<MappedFile> file = MappedFile::open(path, MappedFile::Access::copy_on_write);
+    if (!file || file->size() < sizeof(BinaryMazeHeader)) return std::nullopt;
+
+    BinaryMazeHeader header;
+    std::memcpy(&header, file->data().data(), sizeof(header));
+    if (!valid_header(header, file->size())) return std::nullopt;
+
+    /* the maze owns the mapping -> lives as long as the maze (or a copy of the owner) */
+    auto mapping = std::make_shared<MappedFile>(std::move(*file));
+    auto* const words = reinterpret_cast<BitMaze::Word*>(mapping->mutable_data().data() + sizeof(BinaryMazeHeader));
+    BitMaze maze(header.width, header.height, words, std::move(mapping));
+
+    /* cells past the width would become nodes outside of the maze */
+    if (!valid_padding(maze)) return std::nullopt;
+    if (verify_checksum && maze_hash(maze) != header.checksum)
+        return std::nullopt;
+    return maze;
+}
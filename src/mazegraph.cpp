@@ -1,30 +1,63 @@
 // Created by felix on 11/10/22.
 #include <mazegraph.hpp>
 
-mazes::MazeGraph mazes::graph_from_maze(const Maze& maze) {
-    assert(valid_maze(maze));
-
-    MazeGraph graph;
-    graph.reserve(maze.size() / 4);
+#include <bit>
+#include <thread>
+#include <algorithm>
+#include <limits>
 
-    /* For each x: index of closest node in column looking up. */
-    std::vector<uint64_t> prev_up_idxs(maze.width);
+namespace {
+using namespace mazes;
+using Index = MazeGraph::IndexType;
 
+/// @brief Add node for the hole in the top row
+template <typename MazeType>
+void add_entry(MazeGraph& graph, const MazeType& maze, std::vector<Index>& prev_up_idxs) {
     /* Find entry point to maze */
     for (uint32_t x = 1; x < maze.width - 1; x++) {
         const Point p = { x, 0 };
         if (maze.path_at(p)) {
-            uint64_t idx = graph.add_node(p);
+            Index idx = graph.add_node(p);
             prev_up_idxs[x] = idx;
             break;
         }
     }
+}
+
+/// @brief Add node for the hole in the bottom row, connected to the closest node above it
+template <typename MazeType>
+void add_exit(MazeGraph& graph, const MazeType& maze, const std::vector<Index>& prev_up_idxs) {
+    /* Find exit point of maze */
+    for (uint32_t x = 1; x < maze.width - 1; x++) {
+        const Point p = { x, maze.height - 1 };
+        if (maze.path_at(p)) {
+            auto idx = graph.add_node(p);
+            /* Connects to path above */
+            if (maze.path_at({ x, maze.height - 1})) {
+                graph.connect(idx, prev_up_idxs[x]);
+                break;
+            }
+        }
+    }
+}
 
+/// graph_from_maze for any maze storage with path_at
+template <typename MazeType>
+MazeGraph build_graph(const MazeType& maze) {
+    assert(valid_maze(maze));
+
+    MazeGraph graph;
+    graph.reserve(maze.size() / 4);
+
+    /* For each x: index of closest node in column looking up. */
+    std::vector<Index> prev_up_idxs(maze.width);
+
+    add_entry(graph, maze, prev_up_idxs);
 
     /* Find all turns/dead ends in maze */
     for (uint32_t y = 1; y < maze.height - 1; y++) { /* reduced loop to avoid bounds checking */
         /* for each y: index of closets node in row looking to the left */
-        uint64_t prev_left_idx = UINT64_MAX;
+        Index prev_left_idx = MazeGraph::EdgesType::nullidx;
         for (uint32_t x = 1; x < maze.width - 1; x++) {
             if (maze.at({x,y}) != Maze::path)
                 continue;
@@ -42,7 +75,7 @@ mazes::MazeGraph mazes::graph_from_maze(const Maze& maze) {
             if (mask == 0b11 || mask == 0b1100)
                 continue;
 
-            const uint64_t new_index = graph.add_node({x, y});
+            const Index new_index = graph.add_node({x, y});
 
             /* If path is open to the left */
             if (mask & 0b0001)
@@ -58,23 +91,243 @@ mazes::MazeGraph mazes::graph_from_maze(const Maze& maze) {
         }
     }
 
-    /* Find exit point of maze */
-    for (uint32_t x = 1; x < maze.width - 1; x++) {
-        const Point p = { x, maze.height - 1 };
-        if (maze.path_at(p)) {
-            auto idx = graph.add_node(p);
-            /* Connects to path above */
-            if (maze.path_at({ x, maze.height - 1})) {
-                graph.connect(idx, prev_up_idxs[x]);
-                break;
+    add_exit(graph, maze, prev_up_idxs);
+
+    return graph;
+}
+
+/// Cells of one 64 cell word of a row, as bitmasks: bit i is cell word * 64 + i
+struct RowWord {
+    BitMaze::Word nodes; /* path cells that are not a straight pass-through -> decision points */
+    BitMaze::Word left;  /* cells with path to the left */
+    BitMaze::Word up;    /* cells with path above */
+};
+
+/// @brief Compute the decision points of word w of row y (0 < y < height - 1) from the shifted
+///        words of the row and its neighbours, 64 cells at a time
+inline RowWord row_word(const BitMaze& maze, const uint32_t y, const uint32_t w) noexcept {
+    using Word = BitMaze::Word;
+    const std::span<const Word> row = maze.row(y);
+    const Word path = row[w];
+    if (path == 0) return { 0, 0, 0 };
+
+    /* neighbour in direction -> shift the row by one cell, carrying the bit over word borders */
+    const Word left  = (path << 1) | (w > 0 ? row[w - 1] >> 63 : 0);
+    const Word right = (path >> 1) | (w + 1 < maze.stride ? row[w + 1] << 63 : 0);
+    const Word up    = maze.row(y - 1)[w];
+    const Word down  = maze.row(y + 1)[w];
+
+    /* passthrough (l-r) or (u-d) -> no node */
+    const Word horizontal = left & right & ~up & ~down;
+    const Word vertical   = up & down & ~left & ~right;
+
+    /* first and last column are never nodes */
+    Word interior = ~Word(0);
+    if (w == 0) interior &= ~Word(1);
+    if (w == (maze.width - 1) / BitMaze::word_bits)
+        interior &= ~(Word(1) << ((maze.width - 1) % BitMaze::word_bits));
+
+    return { path & ~(horizontal | vertical) & interior, left, up };
+}
+
+/// graph_from_maze on the words of a bit-packed maze. Same nodes, in the same order, as build_graph
+MazeGraph build_graph_words(const BitMaze& maze) {
+    assert(valid_maze(maze));
+
+    /* count nodes first -> single allocation of exactly the right size */
+    uint64_t nnodes = 2;
+    for (uint32_t y = 1; y < maze.height - 1; y++)
+        for (uint32_t w = 0; w < maze.stride; w++)
+            nnodes += std::popcount(row_word(maze, y, w).nodes);
+
+    MazeGraph graph;
+    graph.reserve(nnodes);
+
+    /* For each x: index of closest node in column looking up. */
+    std::vector<Index> prev_up_idxs(maze.width);
+
+    add_entry(graph, maze, prev_up_idxs);
+
+    /* all inner nodes at once, written by index below. The exit is appended by add_exit */
+    graph.nodes().resize(nnodes - 1);
+    graph.adjacency_list().resize(nnodes - 1);
+    Point* const points = graph.nodes().data();
+    MazeGraph::EdgesType* const adj = graph.adjacency_list().data();
+
+    /* nodes and edges are in range by construction -> no checked node()/connect() per cell */
+    const auto connect = [adj](const Index a, const Index b) {
+        adj[a].add_adjacency(b);
+        adj[b].add_adjacency(a);
+    };
+
+    Index next_index = 1; /* after the entry */
+    for (uint32_t y = 1; y < maze.height - 1; y++) {
+        /* for each y: index of closets node in row looking to the left */
+        Index prev_left_idx = MazeGraph::EdgesType::nullidx;
+        for (uint32_t w = 0; w < maze.stride; w++) {
+            const RowWord cells = row_word(maze, y, w);
+
+            /* visit only the set bits: decision points, left to right */
+            for (BitMaze::Word nodes = cells.nodes; nodes != 0; nodes &= nodes - 1) {
+                const uint32_t bit = std::countr_zero(nodes);
+                const uint32_t x = w * BitMaze::word_bits + bit;
+                const Index new_index = next_index++;
+                points[new_index] = { x, y };
+
+                /* If path is open to the left */
+                if ((cells.left >> bit) & 1)
+                    connect(prev_left_idx, new_index);
+
+                /* If path is open up */
+                if ((cells.up >> bit) & 1)
+                    connect(prev_up_idxs[x], new_index);
+
+                /* Update previous node for row and column */
+                prev_left_idx = new_index;
+                prev_up_idxs[x] = new_index;
             }
         }
     }
+    assert(next_index == graph.size());
+
+    add_exit(graph, maze, prev_up_idxs);
 
     return graph;
 }
 
-bool mazes::valid_maze(const mazes::Maze &maze) {
+/// Up edge of a node in the first row of a band whose node above lies in an earlier band
+struct PendingUp {
+    uint32_t x;
+    Index node;
+    uint32_t slot; /* position of the placeholder in the edges of node */
+};
+
+/// Rows [y0, y1) of the maze, built independently of all other bands
+struct Band {
+    uint32_t y0, y1;
+    Index first_index;                /* index of the first node of the band in the graph */
+    std::vector<PendingUp> pending;   /* up edges to stitch to earlier bands */
+    std::vector<Index> last_up_idxs;  /* for each x: last node of the band in that column, or nullidx */
+};
+
+/// @return number of nodes in rows [y0, y1)
+uint64_t count_nodes(const BitMaze& maze, const uint32_t y0, const uint32_t y1) {
+    uint64_t n = 0;
+    for (uint32_t y = y0; y < y1; y++)
+        for (uint32_t w = 0; w < maze.stride; w++)
+            n += std::popcount(row_word(maze, y, w).nodes);
+    return n;
+}
+
+/// @brief Create the nodes of a band at [first_index, ...) in graph, which is already sized, and their edges
+///        within the band. Up edges leaving the band get a placeholder slot, so that the order of every
+///        edge list (left, up, right, down) is the same as in build_graph_words.
+void build_band(MazeGraph& graph, const BitMaze& maze, Band& band) {
+    constexpr Index nullidx = MazeGraph::EdgesType::nullidx;
+    band.last_up_idxs.assign(maze.width, nullidx);
+
+    Index next_index = band.first_index;
+    for (uint32_t y = band.y0; y < band.y1; y++) {
+        Index prev_left_idx = nullidx;
+        for (uint32_t w = 0; w < maze.stride; w++) {
+            const RowWord cells = row_word(maze, y, w);
+
+            for (BitMaze::Word nodes = cells.nodes; nodes != 0; nodes &= nodes - 1) {
+                const uint32_t bit = std::countr_zero(nodes);
+                const uint32_t x = w * BitMaze::word_bits + bit;
+                const Index new_index = next_index++;
+                graph.node(new_index) = { x, y };
+
+                if ((cells.left >> bit) & 1)
+                    graph.connect(prev_left_idx, new_index);
+
+                if ((cells.up >> bit) & 1) {
+                    if (band.last_up_idxs[x] != nullidx) {
+                        graph.connect(band.last_up_idxs[x], new_index);
+                    } else {
+                        /* node above is in an earlier band -> fill in when stitching */
+                        band.pending.push_back({ x, new_index, uint32_t(graph.edges(new_index).size()) });
+                        graph.add_edge(new_index, nullidx);
+                    }
+                }
+
+                prev_left_idx = new_index;
+                band.last_up_idxs[x] = new_index;
+            }
+        }
+    }
+}
+
+/// @brief Run f(i) for i in [0, n) on n threads
+template <typename F>
+void run_parallel(const uint64_t n, F f) {
+    std::vector<std::thread> threads;
+    threads.reserve(n);
+    for (uint64_t i = 0; i < n; i++)
+        threads.emplace_back(f, i);
+    for (std::thread& t : threads)
+        t.join();
+}
+
+/// graph_from_maze on horizontal bands of rows, one per thread. Same graph as build_graph_words
+MazeGraph build_graph_bands(const BitMaze& maze, uint32_t nbands) {
+    assert(valid_maze(maze));
+
+    const uint32_t inner_rows = maze.height - 2;
+    nbands = std::clamp<uint32_t>(nbands, 1, std::max<uint32_t>(inner_rows, 1));
+
+    std::vector<Band> bands(nbands);
+    for (uint32_t b = 0; b < nbands; b++) {
+        bands[b].y0 = 1 + uint64_t(inner_rows) * b / nbands;
+        bands[b].y1 = 1 + uint64_t(inner_rows) * (b + 1) / nbands;
+    }
+
+    /* 1. count nodes per band -> index of the first node of each band (nodes are numbered row by row) */
+    std::vector<uint64_t> counts(nbands);
+    run_parallel(nbands, [&](const uint64_t b) {
+        counts[b] = count_nodes(maze, bands[b].y0, bands[b].y1);
+    });
+
+    MazeGraph graph;
+    std::vector<Index> prev_up_idxs(maze.width);
+    add_entry(graph, maze, prev_up_idxs);
+
+    uint64_t total = graph.size();
+    for (uint32_t b = 0; b < nbands; b++) {
+        bands[b].first_index = total;
+        total += counts[b];
+    }
+    assert(total < std::numeric_limits<Index>::max() && "Index type too small for graph");
+
+    graph.reserve(total + 1);
+    graph.nodes().resize(total);
+    graph.adjacency_list().resize(total);
+
+    /* 2. build bands, each writes only its own nodes */
+    run_parallel(nbands, [&](const uint64_t b) {
+        build_band(graph, maze, bands[b]);
+    });
+
+    /* 3. stitch vertical edges across bands, top to bottom. The down edge of the upper node is always
+          its last one, so appending keeps the edge order of the sequential builder. */
+    for (Band& band : bands) {
+        for (const PendingUp& up : band.pending) {
+            graph.edges(up.node)[up.slot] = prev_up_idxs[up.x];
+            graph.add_edge(prev_up_idxs[up.x], up.node);
+        }
+        for (uint32_t x = 0; x < maze.width; x++)
+            if (band.last_up_idxs[x] != MazeGraph::EdgesType::nullidx)
+                prev_up_idxs[x] = band.last_up_idxs[x];
+    }
+
+    add_exit(graph, maze, prev_up_idxs);
+
+    return graph;
+}
+
+/// valid_maze for any maze storage with at
+template <typename MazeType>
+bool is_valid(const MazeType& maze) {
     /* check walls */
     for (uint32_t y = 0; y < maze.height; y++)
         if (maze.at({0, y}) != Maze::wall ||
@@ -93,3 +346,56 @@ bool mazes::valid_maze(const mazes::Maze &maze) {
     return true;
 }
 
+/// @brief Length of the corridor between the nodes of an edge: edges are horizontal or vertical
+///        straight corridors, because every corner is a node
+template <Graph G>
+uint32_t corridor_length(const G& graph, const uint64_t a, const uint64_t b) {
+    const Point p = graph.node(a), o = graph.node(b);
+    assert(p.x == o.x || p.y == o.y);
+    return std::max(p.x, o.x) - std::min(p.x, o.x) + std::max(p.y, o.y) - std::min(p.y, o.y);
+}
+
+template <typename MazeType>
+WeightedMazeGraph build_weighted_graph(const MazeType& maze) {
+    const MazeGraph graph = graph_from_maze(maze);
+    return graph.freeze<uint32_t>([&graph](const uint64_t a, const uint64_t b) {
+        return corridor_length(graph, a, b);
+    });
+}
+} // namespace
+
+mazes::MazeGraph mazes::graph_from_maze(const Maze& maze) {
+    return build_graph(maze);
+}
+
+mazes::MazeGraph mazes::graph_from_maze(const BitMaze& maze) {
+    return build_graph_words(maze);
+}
+
+mazes::WeightedMazeGraph mazes::weighted_graph_from_maze(const Maze& maze) {
+    return build_weighted_graph(maze);
+}
+
+mazes::WeightedMazeGraph mazes::weighted_graph_from_maze(const BitMaze& maze) {
+    return build_weighted_graph(maze);
+}
+
+mazes::WeightedMazeGraph mazes::with_corridor_lengths(const MazeCsrGraph& graph) {
+    return WeightedMazeGraph(graph, [&graph](const uint64_t a, const uint64_t b) {
+        return corridor_length(graph, a, b);
+    });
+}
+
+mazes::MazeGraph mazes::graph_from_maze_parallel(const BitMaze& maze, uint32_t nthreads) {
+    if (nthreads == 0)
+        nthreads = std::max(std::thread::hardware_concurrency(), 1u);
+    return build_graph_bands(maze, nthreads);
+}
+
+bool mazes::valid_maze(const Maze& maze) {
+    return is_valid(maze);
+}
+
+bool mazes::valid_maze(const BitMaze& maze) {
+    return is_valid(maze);
+}
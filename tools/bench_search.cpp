@@ -0,0 +1,107 @@
+#include <mazegraph.hpp>
+#include <maze_io.hpp>
+#include <search_workspace.hpp>
+#include <algorithms/breadth_first.hpp>
+#include <algorithms/depth_first.hpp>
+#include <algorithms/dijkstra.hpp>
+#include <algorithms/astar.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <optional>
+#include <random>
+#include <string>
+
+/* count every heap allocation of the process */
+static std::atomic<uint64_t> allocations { 0 };
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+/// Query times of the search algorithms with a fresh and with a warm SearchWorkspace.
+/// Asserts that warm queries do not allocate.
+int main(int argc, char** argv) {
+    using namespace mazes;
+    using namespace std::chrono;
+
+    const char* maze_path = argc > 1 ? argv[1] : MAZES_DATA_DIR "/101x101.txt";
+    const uint64_t nqueries = argc > 2 ? std::stoull(argv[2]) : 1000;
+
+    const std::optional<Maze> maze = load_maze(maze_path);
+    if (!maze) {
+        std::cerr << "Could not load maze from " << maze_path << "\n";
+        return 1;
+    }
+    const MazeGraph graph = graph_from_maze(*maze);
+
+    std::mt19937_64 rng(1);
+    std::vector<std::pair<uint64_t, uint64_t>> queries(nqueries);
+    for (auto& [from, to] : queries) {
+        from = rng() % graph.size();
+        to = rng() % graph.size();
+    }
+
+    const auto edgelen = [&graph](const uint64_t a, const uint64_t b) -> float {
+        const Point p = graph.node(a), o = graph.node(b);
+        return float(std::abs(long(p.x) - long(o.x)) + std::abs(long(p.y) - long(o.y)));
+    };
+
+    bool ok = true;
+    /* run all queries with a fresh workspace per query, then twice with one workspace:
+       once to warm it up, once counting allocations */
+    const auto bench = [&](const char* name, auto&& search) {
+        SearchWorkspace<MazeGraph::IndexType, float> workspace;
+
+        auto start = steady_clock::now();
+        for (const auto& [from, to] : queries) {
+            SearchWorkspace<MazeGraph::IndexType, float> fresh;
+            search(from, to, fresh);
+        }
+        const duration<double, std::micro> cold = steady_clock::now() - start;
+
+        for (const auto& [from, to] : queries)
+            search(from, to, workspace);
+
+        const uint64_t before = allocations.load();
+        start = steady_clock::now();
+        for (const auto& [from, to] : queries)
+            search(from, to, workspace);
+        const duration<double, std::micro> warm = steady_clock::now() - start;
+        const uint64_t allocs = allocations.load() - before;
+
+        std::cout << name << ": " << cold.count() / nqueries << " µs per query fresh, "
+                  << warm.count() / nqueries << " µs warm, " << allocs << " allocations warm\n";
+        ok &= allocs == 0;
+    };
+
+    bench("BreadthFirst", [&](uint64_t from, uint64_t to, auto& ws) {
+        return BreadthFirst::search(graph, from, to, ws);
+    });
+    bench("Dijkstra", [&](uint64_t from, uint64_t to, auto& ws) {
+        return Dijkstra::search(graph, from, to, edgelen, ws);
+    });
+    bench("AStar", [&](uint64_t from, uint64_t to, auto& ws) {
+        const Point end = graph.node(to);
+        return AStar::search(graph, from, to, edgelen, [&graph, end](const uint64_t n) -> float {
+            const Point p = graph.node(n);
+            return float(std::abs(long(end.x) - long(p.x)) + std::abs(long(end.y) - long(p.y)));
+        }, ws);
+    });
+    bench("DepthFirst", [&](uint64_t from, uint64_t to, auto& ws) {
+        return DepthFirst::search(graph, from, to, ws);
+    });
+
+    if (!ok) {
+        std::cerr << "warm queries allocated\n";
+        return 1;
+    }
+    return 0;
+}
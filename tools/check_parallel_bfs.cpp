@@ -0,0 +1,64 @@
+#include <mazegraph.hpp>
+#include <maze_io.hpp>
+#include <algorithms/breadth_first.hpp>
+#include <algorithms/parallel_breadth_first.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+/// Checks that ParallelBreadthFirst finds the paths of BreadthFirst::search when every level with
+/// at least 2 nodes is expanded by all threads, top-down and bottom-up, on the given mazes
+/// (default: the mazes of the repository). Fails on the first difference.
+int main(int argc, char** argv) {
+    using namespace mazes;
+
+    std::vector<std::string> paths(argv + 1, argv + argc);
+    if (paths.empty())
+        for (const char* name : { "8x6.txt", "10x10.txt", "21x21.txt", "50x50.txt", "101x101.txt" })
+            paths.push_back(std::string(MAZES_DATA_DIR "/") + name);
+
+    constexpr uint64_t min_parallel_frontier = 2;
+    constexpr uint64_t nqueries = 200;
+
+    uint64_t checked = 0;
+    for (const std::string& path : paths) {
+        const std::optional<Maze> maze = load_maze(path);
+        if (!maze) {
+            std::cerr << "Could not load maze from " << path << "\n";
+            return 1;
+        }
+        const MazeGraph graph = graph_from_maze(*maze);
+        const CsrGraph csr = graph.freeze();
+
+        std::mt19937_64 rng(1);
+        for (const uint32_t nthreads : { 2u, 3u, 8u }) {
+            /* the whole tree from the entry: every path of it is the path of the serial search */
+            const auto tree = ParallelBreadthFirst::sweep(graph, 0, nthreads, min_parallel_frontier);
+            for (uint64_t to = 0; to < graph.size(); to++) {
+                if (tree.path(to) != BreadthFirst::search(graph, 0, to)) {
+                    std::cerr << path << ": sweep with " << nthreads << " threads differs at node " << to << "\n";
+                    return 1;
+                }
+            }
+
+            for (uint64_t q = 0; q < nqueries; q++) {
+                const uint64_t from = rng() % graph.size(), to = rng() % graph.size();
+                const auto expected = BreadthFirst::search(graph, from, to);
+                if (ParallelBreadthFirst::search(graph, from, to, nthreads, min_parallel_frontier) != expected
+                    || ParallelBreadthFirst::search(csr, from, to, nthreads, min_parallel_frontier) != expected) {
+                    std::cerr << path << ": search " << from << " -> " << to << " with " << nthreads
+                              << " threads differs\n";
+                    return 1;
+                }
+            }
+            checked += graph.size() + nqueries;
+        }
+        std::cout << path << ": " << graph.size() << " nodes, same paths as BreadthFirst::search\n";
+    }
+    std::cout << checked << " paths checked\n";
+    return 0;
+}
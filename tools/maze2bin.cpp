@@ -0,0 +1,27 @@
+#include <maze_io.hpp>
+
+#include <iostream>
+
+/// Convert a text maze (e.g. 101x101.txt) to the binary maze format
+int main(int argc, char** argv) {
+    using namespace mazes;
+
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <maze.txt> <maze.bin>\n";
+        return 2;
+    }
+
+    const std::optional<BitMaze> maze = load_bitmaze(argv[1]);
+    if (!maze) {
+        std::cerr << "Could not load text maze from " << argv[1] << "\n";
+        return 1;
+    }
+
+    if (!save_binary_maze(*maze, argv[2])) {
+        std::cerr << "Could not write " << argv[2] << "\n";
+        return 1;
+    }
+
+    std::cout << "Wrote " << maze->width << "x" << maze->height << " maze to " << argv[2] << "\n";
+    return 0;
+}